@@ -20,6 +20,8 @@ Revision History:
 #include "api/api_log_macros.h"
 #include "api/api_context.h"
 #include "api/api_util.h"
+#include "api/api_ast_vector.h"
+#include "ast/ast_binary.h"
 #include "cmd_context/cmd_context.h"
 #include "parsers/smt2/smt2parser.h"
 #include "solver/solver_na2as.h"
@@ -117,4 +119,58 @@ extern "C" {
         RETURN_Z3(r);
         Z3_CATCH_RETURN(nullptr);
     }
+
+    // ---------------
+    // Support for the binary format
+
+    Z3_ast_vector Z3_API Z3_parse_binary_file(Z3_context c, Z3_string file_name) {
+        Z3_TRY;
+        LOG_Z3_parse_binary_file(c, file_name);
+        RESET_ERROR_CODE();
+        std::ifstream is(file_name, std::ios::in | std::ios::binary);
+        if (!is) {
+            mk_c(c)->m_parser_error_buffer = "failed to open file";
+            SET_ERROR_CODE(Z3_PARSER_ERROR);
+            return nullptr;
+        }
+        Z3_ast_vector_ref * v = alloc(Z3_ast_vector_ref, *mk_c(c), mk_c(c)->m());
+        mk_c(c)->save_object(v);
+        expr_ref_vector fmls(mk_c(c)->m());
+        try {
+            ast_binary_read(is, mk_c(c)->m(), fmls);
+        }
+        catch (z3_exception & e) {
+            mk_c(c)->m_parser_error_buffer = e.msg();
+            SET_ERROR_CODE(Z3_PARSER_ERROR);
+            return nullptr;
+        }
+        for (expr * f : fmls) {
+            v->m_ast_vector.push_back(f);
+        }
+        RETURN_Z3(of_ast_vector(v));
+        Z3_CATCH_RETURN(nullptr);
+    }
+
+    void Z3_API Z3_write_binary_file(Z3_context c, Z3_string file_name, unsigned num, Z3_ast const fmls[]) {
+        Z3_TRY;
+        LOG_Z3_write_binary_file(c, file_name, num, fmls);
+        RESET_ERROR_CODE();
+        for (unsigned i = 0; i < num; i++) {
+            if (!is_expr(to_ast(fmls[i]))) {
+                SET_ERROR_CODE(Z3_INVALID_ARG);
+                return;
+            }
+        }
+        std::ofstream os(file_name, std::ios::out | std::ios::binary);
+        if (!os) {
+            SET_ERROR_CODE(Z3_FILE_ACCESS_ERROR);
+            return;
+        }
+        ast_binary_write(os, mk_c(c)->m(), num, to_exprs(fmls));
+        os.close();
+        if (os.fail()) {
+            SET_ERROR_CODE(Z3_FILE_ACCESS_ERROR);
+        }
+        Z3_CATCH;
+    }
 };
@@ -5208,6 +5208,27 @@ extern "C" {
                                         Z3_symbol const decl_names[],
                                         Z3_func_decl const decls[]);
 
+    /**
+       \brief Read the formulas stored in a file in the compact binary format of #Z3_write_binary_file.
+
+       Shared subterms are rebuilt once, so the DAG structure of the stored formulas is
+       preserved. If the file cannot be read or is malformed, the error code is set to
+       #Z3_PARSER_ERROR and the message is available from #Z3_get_parser_error.
+
+       def_API('Z3_parse_binary_file', AST_VECTOR, (_in(CONTEXT), _in(STRING)))
+    */
+    Z3_ast_vector Z3_API Z3_parse_binary_file(Z3_context c, Z3_string file_name);
+
+    /**
+       \brief Write the formulas \c fmls[0], ..., \c fmls[num-1] to a file in a compact binary format.
+
+       Every sort, declaration and subterm is stored once, so sharing between and within the
+       formulas is preserved. The file can be read back with #Z3_parse_binary_file, or by the
+       shell with the option -binary. Datatype sorts are not supported.
+
+       def_API('Z3_write_binary_file', VOID, (_in(CONTEXT), _in(STRING), _in(UINT), _in_array(2, AST)))
+    */
+    void Z3_API Z3_write_binary_file(Z3_context c, Z3_string file_name, unsigned num, Z3_ast const fmls[]);
 
     /**
        \brief Retrieve that last error message information generated from parsing.
@@ -365,12 +365,12 @@ quantifier::quantifier(bool forall, unsigned num_decls, sort * const * decl_sort
                        unsigned num_no_patterns, expr * const * no_patterns):
     expr(AST_QUANTIFIER),
     m_forall(forall),
+    m_has_unused_vars(true),
+    m_has_labels(::has_labels(body)),
     m_num_decls(num_decls),
     m_expr(body),
     m_depth(::get_depth(body) + 1),
     m_weight(weight),
-    m_has_unused_vars(true),
-    m_has_labels(::has_labels(body)),
     m_qid(qid),
     m_skid(skid),
     m_num_patterns(num_patterns),
@@ -1663,8 +1663,8 @@ bool ast_manager::slow_not_contains(ast const * n) {
 }
 #endif
 
-ast * ast_manager::register_node_core(ast * n) {
-    unsigned h = get_node_hash(n);
+ast * ast_manager::register_node_core(ast * n, unsigned h) {
+    SASSERT(h == get_node_hash(n));
     n->m_hash = h;
 #ifdef Z3DEBUG
     bool contains = m_ast_table.contains(n);
@@ -2061,14 +2061,43 @@ bool ast_manager::coercion_needed(func_decl * decl, unsigned num_args, expr * co
     return false;
 }
 
+/**
+   \brief Return the application decl(args) if it is already in the AST table, and nullptr otherwise.
+   The lookup uses a probe node on the stack, so it does not allocate.
+   Store in h the hash of the application, or UINT_MAX if it was not computed.
+*/
+app * ast_manager::find_app_core(func_decl * decl, unsigned num_args, expr * const * args, unsigned & h) {
+    h = UINT_MAX;
+    if (num_args > PROBE_APP_MAX_ARGS)
+        return nullptr;
+    void * mem[(sizeof(app) + PROBE_APP_MAX_ARGS * sizeof(expr*)) / sizeof(void*) + 1];
+    app * probe = new (mem) app(decl, num_args, args);
+    h = get_node_hash(probe);
+    probe->m_hash = h;
+    ast * r = nullptr;
+    if (m_ast_table.find(probe, r))
+        return to_app(r);
+    return nullptr;
+}
+
 app * ast_manager::mk_app_core(func_decl * decl, unsigned num_args, expr * const * args) {
+    bool coerce = m_int_real_coercions && coercion_needed(decl, num_args, args);
+    unsigned h  = UINT_MAX;
+    if (!coerce) {
+        // Most applications built by rewriters already exist.
+        // Finding them first avoids allocating a node that is released right away.
+        check_args(decl, num_args, args);
+        app * r = find_app_core(decl, num_args, args, h);
+        if (r != nullptr)
+            return r;
+    }
     app * r = nullptr;
     app * new_node = nullptr;
     unsigned sz = app::get_obj_size(num_args);
     void * mem = allocate_node(sz);
 
     try {
-        if (m_int_real_coercions && coercion_needed(decl, num_args, args)) {
+        if (coerce) {
             expr_ref_buffer new_args(*this);
             if (decl->is_associative()) {
                 sort * d = decl->get_domain(0);
@@ -2106,9 +2135,9 @@ app * ast_manager::mk_app_core(func_decl * decl, unsigned num_args, expr * const
             r = register_node(new_node);
         }
         else {
-            check_args(decl, num_args, args);
             new_node = new (mem)app(decl, num_args, args);
-            r = register_node(new_node);
+            // reuse the hash computed by the probe.
+            r = static_cast<app*>(h == UINT_MAX ? register_node_core(new_node) : register_node_core(new_node, h));
         }
 
         if (m_trace_stream && r == new_node) {
@@ -667,18 +667,21 @@ class app : public expr {
 
     func_decl *  m_decl;
     unsigned     m_num_args;
+    // remark: the flags share the word of m_num_args on 64-bit platforms, so they do not
+    // increase the size of the node. They are only meaningful if num_args > 0, constants
+    // use g_constant_flags.
+    app_flags    m_flags;
     expr *       m_args[0];
 
     static app_flags g_constant_flags;
 
-    // remark: store term depth in the end of the app. the depth is only stored if the num_args > 0
     static unsigned get_obj_size(unsigned num_args) {
-        return num_args == 0 ? sizeof(app) : sizeof(app) + num_args * sizeof(expr *) + sizeof(app_flags);
+        return sizeof(app) + num_args * sizeof(expr *);
     }
 
     friend class tmp_app;
 
-    app_flags * flags() const { return m_num_args == 0 ? &g_constant_flags : reinterpret_cast<app_flags*>(const_cast<expr**>(m_args + m_num_args)); }
+    app_flags * flags() const { return m_num_args == 0 ? &g_constant_flags : const_cast<app_flags*>(&m_flags); }
 
     app(func_decl * decl, unsigned num_args, expr * const * args);
 public:
@@ -792,14 +795,15 @@ public:
 
 class quantifier : public expr {
     friend class ast_manager;
+    // the Boolean fields are kept together to avoid padding.
     bool                m_forall;
+    bool                m_has_unused_vars;
+    bool                m_has_labels;
     unsigned            m_num_decls;
     expr *              m_expr;
     unsigned            m_depth;
     // extra fields
     int                 m_weight;
-    bool                m_has_unused_vars;
-    bool                m_has_labels;
     symbol              m_qid;
     symbol              m_skid;
     unsigned            m_num_patterns;
@@ -1634,7 +1638,11 @@ public:
     }
 
 protected:
-    ast * register_node_core(ast * n);
+    ast * register_node_core(ast * n, unsigned h);
+    ast * register_node_core(ast * n) { return register_node_core(n, get_node_hash(n)); }
+
+    static const unsigned PROBE_APP_MAX_ARGS = 16;
+    app * find_app_core(func_decl * decl, unsigned num_args, expr * const * args, unsigned & h);
 
     template<typename T>
     T * register_node(T * n) {
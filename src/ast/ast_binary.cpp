@@ -0,0 +1,667 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    ast_binary.cpp
+
+Abstract:
+
+    Compact binary serialization of expression DAGs.
+
+    Layout:
+
+       header  := 'Z' '3' 'A' 'B' version
+       record  := SORT | DECL | APP | VAR | QUANTIFIER | ROOT
+       stream  := header record* END
+
+    Numbers are LEB128 varints, signed numbers are zig-zag coded.
+    Every node record defines the next node index, and node records
+    only refer to smaller indices. Symbols are written in full the
+    first time and then by index.
+
+--*/
+#include<cstring>
+#include "ast/ast_binary.h"
+#include "util/map.h"
+#include "util/z3_exception.h"
+
+namespace {
+
+    const char     AB_MAGIC[4] = { 'Z', '3', 'A', 'B' };
+    const unsigned AB_VERSION  = 2;
+
+    enum ab_tag {
+        AB_END = 0,
+        AB_SORT,
+        AB_DECL,
+        AB_APP,
+        AB_VAR,
+        AB_QUANTIFIER,
+        AB_ROOT
+    };
+
+    enum ab_symbol_tag {
+        AB_SYM_NULL = 0,
+        AB_SYM_NUM,
+        AB_SYM_NEW,
+        AB_SYM_REF
+    };
+
+    enum ab_decl_flag {
+        AB_LEFT_ASSOC  = 1 << 0,
+        AB_RIGHT_ASSOC = 1 << 1,
+        AB_FLAT_ASSOC  = 1 << 2,
+        AB_COMM        = 1 << 3,
+        AB_CHAINABLE   = 1 << 4,
+        AB_PAIRWISE    = 1 << 5,
+        AB_INJECTIVE   = 1 << 6,
+        AB_SKOLEM      = 1 << 7,
+        AB_IDEMPOTENT  = 1 << 8
+    };
+
+    class writer {
+        typedef map<symbol, unsigned, symbol_hash_proc, symbol_eq_proc> symbol2idx;
+        ast_manager &          m;
+        std::ostream &         m_out;
+        obj_map<ast, unsigned> m_ids;
+        symbol2idx             m_symbols;
+        ptr_vector<ast>        m_todo;
+        symbol                 m_datatype;
+
+        void write_byte(unsigned char c) {
+            m_out.put(c);
+        }
+
+        void write_uint64(uint64 n) {
+            while (n >= 0x80) {
+                write_byte(static_cast<unsigned char>(n | 0x80));
+                n >>= 7;
+            }
+            write_byte(static_cast<unsigned char>(n));
+        }
+
+        void write_unsigned(unsigned n) {
+            write_uint64(n);
+        }
+
+        void write_int(int n) {
+            write_unsigned((static_cast<unsigned>(n) << 1) ^ static_cast<unsigned>(n >> 31));
+        }
+
+        void write_string(char const * s) {
+            unsigned len = static_cast<unsigned>(strlen(s));
+            write_unsigned(len);
+            m_out.write(s, len);
+        }
+
+        void write_symbol(symbol const & s) {
+            unsigned idx;
+            if (s == symbol::null) {
+                write_byte(AB_SYM_NULL);
+            }
+            else if (s.is_numerical()) {
+                write_byte(AB_SYM_NUM);
+                write_unsigned(s.get_num());
+            }
+            else if (m_symbols.find(s, idx)) {
+                write_byte(AB_SYM_REF);
+                write_unsigned(idx);
+            }
+            else {
+                write_byte(AB_SYM_NEW);
+                write_string(s.bare_str());
+                m_symbols.insert(s, m_symbols.size());
+            }
+        }
+
+        void write_ref(ast * n) {
+            write_unsigned(m_ids[n]);
+        }
+
+        void write_family(family_id fid) {
+            write_symbol(fid == null_family_id ? symbol::null : m.get_family_name(fid));
+        }
+
+        void write_parameters(decl * d) {
+            unsigned num = d->get_num_parameters();
+            write_unsigned(num);
+            for (unsigned i = 0; i < num; ++i) {
+                parameter const & p = d->get_parameter(i);
+                write_byte(static_cast<unsigned char>(p.get_kind()));
+                switch (p.get_kind()) {
+                case parameter::PARAM_INT:
+                    write_int(p.get_int());
+                    break;
+                case parameter::PARAM_AST:
+                    write_ref(p.get_ast());
+                    break;
+                case parameter::PARAM_SYMBOL:
+                    write_symbol(p.get_symbol());
+                    break;
+                case parameter::PARAM_RATIONAL:
+                    write_string(p.get_rational().to_string().c_str());
+                    break;
+                case parameter::PARAM_DOUBLE: {
+                    double d = p.get_double();
+                    uint64 bits;
+                    memcpy(&bits, &d, sizeof(d));
+                    write_uint64(bits);
+                    break;
+                }
+                default:
+                    throw default_exception("binary AST format does not support external parameters");
+                }
+            }
+        }
+
+        void write_sort(sort * s) {
+            sort_info * si = s->get_info();
+            write_byte(AB_SORT);
+            write_symbol(s->get_name());
+            if (si == nullptr) {
+                write_byte(0);
+                return;
+            }
+            if (si->get_family_id() != null_family_id &&
+                m.get_family_name(si->get_family_id()) == m_datatype) {
+                throw default_exception("binary AST format does not support datatype sorts");
+            }
+            write_byte(1);
+            write_family(si->get_family_id());
+            write_int(si->get_decl_kind());
+            write_byte(si->private_parameters());
+            write_parameters(s);
+        }
+
+        void write_func_decl(func_decl * f) {
+            func_decl_info * fi = f->get_info();
+            write_byte(AB_DECL);
+            write_symbol(f->get_name());
+            write_unsigned(f->get_arity());
+            for (unsigned i = 0; i < f->get_arity(); ++i) {
+                write_ref(f->get_domain(i));
+            }
+            write_ref(f->get_range());
+            if (fi == nullptr) {
+                write_byte(0);
+                return;
+            }
+            write_byte(1);
+            write_family(fi->get_family_id());
+            if (fi->get_family_id() != null_family_id) {
+                // the plugin rebuilds the attributes of an interpreted declaration.
+                write_int(fi->get_decl_kind());
+                write_byte(fi->private_parameters());
+                write_parameters(f);
+                return;
+            }
+            unsigned flags = 0;
+            if (fi->is_left_associative())  flags |= AB_LEFT_ASSOC;
+            if (fi->is_right_associative()) flags |= AB_RIGHT_ASSOC;
+            if (fi->is_flat_associative())  flags |= AB_FLAT_ASSOC;
+            if (fi->is_commutative())       flags |= AB_COMM;
+            if (fi->is_chainable())         flags |= AB_CHAINABLE;
+            if (fi->is_pairwise())          flags |= AB_PAIRWISE;
+            if (fi->is_injective())         flags |= AB_INJECTIVE;
+            if (fi->is_skolem())            flags |= AB_SKOLEM;
+            if (fi->is_idempotent())        flags |= AB_IDEMPOTENT;
+            write_unsigned(flags);
+            write_parameters(f);
+        }
+
+        void write_app(app * a) {
+            write_byte(AB_APP);
+            write_ref(a->get_decl());
+            write_unsigned(a->get_num_args());
+            for (expr * arg : *a) {
+                write_ref(arg);
+            }
+        }
+
+        void write_var(var * v) {
+            write_byte(AB_VAR);
+            write_unsigned(v->get_idx());
+            write_ref(v->get_sort());
+        }
+
+        void write_quantifier(quantifier * q) {
+            write_byte(AB_QUANTIFIER);
+            write_byte(q->is_forall());
+            write_unsigned(q->get_num_decls());
+            for (unsigned i = 0; i < q->get_num_decls(); ++i) {
+                write_ref(q->get_decl_sort(i));
+                write_symbol(q->get_decl_name(i));
+            }
+            write_ref(q->get_expr());
+            write_int(q->get_weight());
+            write_symbol(q->get_qid());
+            write_symbol(q->get_skid());
+            write_unsigned(q->get_num_patterns());
+            for (unsigned i = 0; i < q->get_num_patterns(); ++i) {
+                write_ref(q->get_pattern(i));
+            }
+            write_unsigned(q->get_num_no_patterns());
+            for (unsigned i = 0; i < q->get_num_no_patterns(); ++i) {
+                write_ref(q->get_no_pattern(i));
+            }
+        }
+
+        void visit(ast * n) {
+            if (!m_ids.contains(n)) {
+                m_todo.push_back(n);
+            }
+        }
+
+        void visit_parameters(decl * d) {
+            for (unsigned i = 0; i < d->get_num_parameters(); ++i) {
+                parameter const & p = d->get_parameter(i);
+                if (p.is_ast()) {
+                    visit(p.get_ast());
+                }
+            }
+        }
+
+        void visit_children(ast * n) {
+            switch (n->get_kind()) {
+            case AST_SORT:
+                visit_parameters(to_sort(n));
+                break;
+            case AST_FUNC_DECL: {
+                func_decl * f = to_func_decl(n);
+                visit_parameters(f);
+                for (unsigned i = 0; i < f->get_arity(); ++i) {
+                    visit(f->get_domain(i));
+                }
+                visit(f->get_range());
+                break;
+            }
+            case AST_APP:
+                visit(to_app(n)->get_decl());
+                for (expr * arg : *to_app(n)) {
+                    visit(arg);
+                }
+                break;
+            case AST_VAR:
+                visit(to_var(n)->get_sort());
+                break;
+            case AST_QUANTIFIER: {
+                quantifier * q = to_quantifier(n);
+                for (unsigned i = 0; i < q->get_num_decls(); ++i) {
+                    visit(q->get_decl_sort(i));
+                }
+                visit(q->get_expr());
+                for (unsigned i = 0; i < q->get_num_patterns(); ++i) {
+                    visit(q->get_pattern(i));
+                }
+                for (unsigned i = 0; i < q->get_num_no_patterns(); ++i) {
+                    visit(q->get_no_pattern(i));
+                }
+                break;
+            }
+            }
+        }
+
+        void write_node(ast * n) {
+            switch (n->get_kind()) {
+            case AST_SORT:       write_sort(to_sort(n)); break;
+            case AST_FUNC_DECL:  write_func_decl(to_func_decl(n)); break;
+            case AST_APP:        write_app(to_app(n)); break;
+            case AST_VAR:        write_var(to_var(n)); break;
+            case AST_QUANTIFIER: write_quantifier(to_quantifier(n)); break;
+            }
+            m_ids.insert(n, m_ids.size());
+        }
+
+        void process(ast * root) {
+            visit(root);
+            while (!m_todo.empty()) {
+                ast * n = m_todo.back();
+                if (m_ids.contains(n)) {
+                    m_todo.pop_back();
+                    continue;
+                }
+                unsigned sz = m_todo.size();
+                visit_children(n);
+                if (sz == m_todo.size()) {
+                    m_todo.pop_back();
+                    write_node(n);
+                }
+            }
+        }
+
+    public:
+        writer(ast_manager & m, std::ostream & out):
+            m(m),
+            m_out(out),
+            m_datatype("datatype") {
+        }
+
+        void operator()(unsigned num, expr * const * es) {
+            m_out.write(AB_MAGIC, sizeof(AB_MAGIC));
+            write_unsigned(AB_VERSION);
+            for (unsigned i = 0; i < num; ++i) {
+                process(es[i]);
+                write_byte(AB_ROOT);
+                write_ref(es[i]);
+            }
+            write_byte(AB_END);
+        }
+    };
+
+    class reader {
+        ast_manager &    m;
+        std::streambuf & m_in;
+        ast_ref_vector   m_nodes;
+        svector<symbol>  m_symbols;
+
+        static void error(char const * msg) {
+            throw default_exception(std::string("invalid binary AST input: ") + msg);
+        }
+
+        unsigned char read_byte() {
+            int c = m_in.sbumpc();
+            if (c == EOF) {
+                error("unexpected end of input");
+            }
+            return static_cast<unsigned char>(c);
+        }
+
+        uint64 read_uint64() {
+            uint64 r = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                unsigned char c = read_byte();
+                r |= static_cast<uint64>(c & 0x7f) << shift;
+                if ((c & 0x80) == 0) {
+                    return r;
+                }
+            }
+            error("varint is too long");
+            return 0;
+        }
+
+        unsigned read_unsigned() {
+            uint64 r = read_uint64();
+            if (r > UINT_MAX) {
+                error("number is out of range");
+            }
+            return static_cast<unsigned>(r);
+        }
+
+        int read_int() {
+            unsigned n = read_unsigned();
+            return static_cast<int>((n >> 1) ^ (0u - (n & 1)));
+        }
+
+        void read_string(std::string & s) {
+            unsigned len = read_unsigned();
+            s.resize(len);
+            if (len > 0 && m_in.sgetn(&s[0], len) != static_cast<std::streamsize>(len)) {
+                error("unexpected end of input");
+            }
+        }
+
+        symbol read_symbol() {
+            switch (read_byte()) {
+            case AB_SYM_NULL:
+                return symbol::null;
+            case AB_SYM_NUM:
+                return symbol(read_unsigned());
+            case AB_SYM_NEW: {
+                std::string s;
+                read_string(s);
+                m_symbols.push_back(symbol(s.c_str()));
+                return m_symbols.back();
+            }
+            case AB_SYM_REF: {
+                unsigned idx = read_unsigned();
+                if (idx >= m_symbols.size()) {
+                    error("undefined symbol");
+                }
+                return m_symbols[idx];
+            }
+            default:
+                error("unknown symbol tag");
+                return symbol::null;
+            }
+        }
+
+        ast * read_ref() {
+            unsigned idx = read_unsigned();
+            if (idx >= m_nodes.size()) {
+                error("reference to undefined node");
+            }
+            return m_nodes.get(idx);
+        }
+
+        sort * read_sort_ref() {
+            ast * n = read_ref();
+            if (!is_sort(n)) {
+                error("sort expected");
+            }
+            return to_sort(n);
+        }
+
+        expr * read_expr_ref() {
+            ast * n = read_ref();
+            if (!is_expr(n)) {
+                error("expression expected");
+            }
+            return to_expr(n);
+        }
+
+        family_id read_family() {
+            symbol name = read_symbol();
+            if (name == symbol::null) {
+                return null_family_id;
+            }
+            if (!m.has_plugin(name)) {
+                error("unknown theory");
+            }
+            return m.get_family_id(name);
+        }
+
+        void read_parameters(vector<parameter> & ps) {
+            unsigned num = read_unsigned();
+            for (unsigned i = 0; i < num; ++i) {
+                switch (read_byte()) {
+                case parameter::PARAM_INT:
+                    ps.push_back(parameter(read_int()));
+                    break;
+                case parameter::PARAM_AST:
+                    ps.push_back(parameter(read_ref()));
+                    break;
+                case parameter::PARAM_SYMBOL:
+                    ps.push_back(parameter(read_symbol()));
+                    break;
+                case parameter::PARAM_RATIONAL: {
+                    std::string s;
+                    read_string(s);
+                    ps.push_back(parameter(rational(s.c_str())));
+                    break;
+                }
+                case parameter::PARAM_DOUBLE: {
+                    uint64 bits = read_uint64();
+                    double d;
+                    memcpy(&d, &bits, sizeof(d));
+                    ps.push_back(parameter(d));
+                    break;
+                }
+                default:
+                    error("unknown parameter kind");
+                }
+            }
+        }
+
+        sort * read_sort() {
+            symbol name = read_symbol();
+            if (read_byte() == 0) {
+                return m.mk_uninterpreted_sort(name);
+            }
+            family_id fid = read_family();
+            decl_kind k   = read_int();
+            bool private_params = read_byte() != 0;
+            vector<parameter> ps;
+            read_parameters(ps);
+            if (fid == null_family_id || fid == m.get_user_sort_family_id()) {
+                // the kind of a user sort is local to the manager that declared it.
+                return m.mk_uninterpreted_sort(name, ps.size(), ps.c_ptr());
+            }
+            sort * s = m.mk_sort(fid, k, ps.size(), ps.c_ptr());
+            if (s == nullptr || s->get_family_id() != fid || s->get_decl_kind() != k ||
+                s->private_parameters() != private_params) {
+                error("invalid theory sort");
+            }
+            return s;
+        }
+
+        func_decl * read_func_decl() {
+            symbol name    = read_symbol();
+            unsigned arity = read_unsigned();
+            ptr_buffer<sort> domain;
+            for (unsigned i = 0; i < arity; ++i) {
+                domain.push_back(read_sort_ref());
+            }
+            sort * range = read_sort_ref();
+            if (read_byte() == 0) {
+                return m.mk_func_decl(name, arity, domain.c_ptr(), range);
+            }
+            family_id fid  = read_family();
+            if (fid != null_family_id) {
+                decl_kind k = read_int();
+                bool private_params = read_byte() != 0;
+                vector<parameter> ps;
+                read_parameters(ps);
+                func_decl * f = m.mk_func_decl(fid, k, ps.size(), ps.c_ptr(), arity, domain.c_ptr(), range);
+                if (f == nullptr || f->get_family_id() != fid || f->get_decl_kind() != k ||
+                    f->private_parameters() != private_params || f->get_range() != range) {
+                    error("invalid theory declaration");
+                }
+                return f;
+            }
+            unsigned flags = read_unsigned();
+            vector<parameter> ps;
+            read_parameters(ps);
+            func_decl_info fi(null_family_id, null_decl_kind, ps.size(), ps.c_ptr());
+            fi.set_left_associative((flags & AB_LEFT_ASSOC) != 0);
+            fi.set_right_associative((flags & AB_RIGHT_ASSOC) != 0);
+            fi.set_flat_associative((flags & AB_FLAT_ASSOC) != 0);
+            fi.set_commutative((flags & AB_COMM) != 0);
+            fi.set_chainable((flags & AB_CHAINABLE) != 0);
+            fi.set_pairwise((flags & AB_PAIRWISE) != 0);
+            fi.set_injective((flags & AB_INJECTIVE) != 0);
+            fi.set_skolem((flags & AB_SKOLEM) != 0);
+            fi.set_idempotent((flags & AB_IDEMPOTENT) != 0);
+            return m.mk_func_decl(name, arity, domain.c_ptr(), range, fi);
+        }
+
+        app * read_app() {
+            ast * f = read_ref();
+            if (!is_func_decl(f)) {
+                error("declaration expected");
+            }
+            unsigned num = read_unsigned();
+            ptr_buffer<expr> args;
+            for (unsigned i = 0; i < num; ++i) {
+                args.push_back(read_expr_ref());
+            }
+            return m.mk_app(to_func_decl(f), num, args.c_ptr());
+        }
+
+        var * read_var() {
+            unsigned idx = read_unsigned();
+            return m.mk_var(idx, read_sort_ref());
+        }
+
+        quantifier * read_quantifier() {
+            bool forall = read_byte() != 0;
+            unsigned num_decls = read_unsigned();
+            if (num_decls == 0) {
+                error("quantifier without bound variables");
+            }
+            ptr_buffer<sort> sorts;
+            buffer<symbol>   names;
+            for (unsigned i = 0; i < num_decls; ++i) {
+                sorts.push_back(read_sort_ref());
+                names.push_back(read_symbol());
+            }
+            expr * body = read_expr_ref();
+            if (!m.is_bool(body)) {
+                error("quantifier body must be Boolean");
+            }
+            int weight  = read_int();
+            symbol qid  = read_symbol();
+            symbol skid = read_symbol();
+            ptr_buffer<expr> patterns, no_patterns;
+            unsigned num_patterns = read_unsigned();
+            for (unsigned i = 0; i < num_patterns; ++i) {
+                patterns.push_back(read_expr_ref());
+                if (!m.is_pattern(patterns.back())) {
+                    error("pattern expected");
+                }
+            }
+            unsigned num_no_patterns = read_unsigned();
+            for (unsigned i = 0; i < num_no_patterns; ++i) {
+                no_patterns.push_back(read_expr_ref());
+            }
+            return m.mk_quantifier(forall, num_decls, sorts.c_ptr(), names.c_ptr(), body, weight, qid, skid,
+                                   num_patterns, patterns.c_ptr(), num_no_patterns, no_patterns.c_ptr());
+        }
+
+        void read_records(expr_ref_vector & result) {
+            while (true) {
+                ast * n = nullptr;
+                switch (read_byte()) {
+                case AB_END:        return;
+                case AB_SORT:       n = read_sort(); break;
+                case AB_DECL:       n = read_func_decl(); break;
+                case AB_APP:        n = read_app(); break;
+                case AB_VAR:        n = read_var(); break;
+                case AB_QUANTIFIER: n = read_quantifier(); break;
+                case AB_ROOT:       result.push_back(read_expr_ref()); continue;
+                default:            error("unknown record");
+                }
+                if (n == nullptr) {
+                    error("could not rebuild node");
+                }
+                m_nodes.push_back(n);
+            }
+        }
+
+    public:
+        reader(ast_manager & m, std::istream & in):
+            m(m),
+            m_in(*in.rdbuf()),
+            m_nodes(m) {
+        }
+
+        void operator()(expr_ref_vector & result) {
+            char magic[sizeof(AB_MAGIC)];
+            if (m_in.sgetn(magic, sizeof(magic)) != static_cast<std::streamsize>(sizeof(magic)) ||
+                memcmp(magic, AB_MAGIC, sizeof(magic)) != 0) {
+                error("bad header");
+            }
+            if (read_unsigned() != AB_VERSION) {
+                error("unsupported version");
+            }
+            try {
+                read_records(result);
+            }
+            catch (ast_exception & ex) {
+                // ill-sorted applications, declarations rejected by a plugin, ...
+                error(ex.msg());
+            }
+        }
+    };
+
+};
+
+void ast_binary_write(std::ostream & out, ast_manager & m, unsigned num, expr * const * es) {
+    writer w(m, out);
+    w(num, es);
+}
+
+void ast_binary_read(std::istream & in, ast_manager & m, expr_ref_vector & result) {
+    reader r(m, in);
+    r(result);
+}
@@ -0,0 +1,45 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    ast_binary.h
+
+Abstract:
+
+    Compact binary serialization of expression DAGs.
+
+    The format stores sorts, declarations and expressions in
+    topological order. Every node is written once, and later nodes
+    refer to it by its position in the stream (varint coded), so
+    sharing in the DAG is preserved. Interpreted sorts and
+    declarations are stored as (family name, kind, parameters), so
+    they are rebuilt by the plugins of the target manager.
+
+    Datatype sorts and external parameters are not supported.
+    Functions in this module throw default_exception when they meet
+    them, or when the input is malformed or ill-sorted.
+
+--*/
+#ifndef AST_BINARY_H_
+#define AST_BINARY_H_
+
+#include<iostream>
+#include "ast/ast.h"
+
+/**
+   \brief Write the expressions es[0], ..., es[num-1] to out.
+   Subterms shared between the expressions are written only once.
+*/
+void ast_binary_write(std::ostream & out, ast_manager & m, unsigned num, expr * const * es);
+
+inline void ast_binary_write(std::ostream & out, expr_ref_vector const & es) {
+    ast_binary_write(out, es.get_manager(), es.size(), es.c_ptr());
+}
+
+/**
+   \brief Read expressions written by ast_binary_write into m and append them to result.
+*/
+void ast_binary_read(std::istream & in, ast_manager & m, expr_ref_vector & result);
+
+#endif /* AST_BINARY_H_ */
@@ -0,0 +1,542 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    bv_simulator.cpp
+
+Abstract:
+
+    Bit-parallel simulation of Boolean and bit-vector expressions.
+
+Notes:
+
+--*/
+#include "ast/bv_simulator.h"
+#include "util/hash.h"
+
+static const unsigned N = bv_simulator::num_lanes;
+
+static inline uint64 mask(unsigned sz) {
+    return sz >= 64 ? ~static_cast<uint64>(0) : (static_cast<uint64>(1) << sz) - 1;
+}
+
+// sign extend a value of width sz to 64 bits.
+static inline int64 to_signed(uint64 v, unsigned sz) {
+    if (sz >= 64)
+        return static_cast<int64>(v);
+    uint64 sign = static_cast<uint64>(1) << (sz - 1);
+    return static_cast<int64>((v ^ sign) - sign);
+}
+
+static inline bool msb(uint64 v, unsigned sz) {
+    return ((v >> (sz - 1)) & 1) != 0;
+}
+
+// division with the SMT-LIB semantics for division by zero.
+static inline uint64 udiv(uint64 a, uint64 b, uint64 msk) {
+    return b == 0 ? msk : a / b;
+}
+
+static inline uint64 urem(uint64 a, uint64 b) {
+    return b == 0 ? a : a % b;
+}
+
+bv_simulator::bv_simulator(ast_manager & m, unsigned seed):
+    m(m),
+    m_bv(m),
+    m_rand(seed),
+    m_nodes(m),
+    m_inputs(m) {
+}
+
+void bv_simulator::reset() {
+    m_nodes.reset();
+    m_expr2idx.reset();
+    m_values.reset();
+    m_is_input.reset();
+    m_inputs.reset();
+    m_user_inputs.reset();
+    m_user_values.reset();
+}
+
+uint64 bv_simulator::random_word() {
+    uint64 r = 0;
+    for (unsigned i = 0; i < 5; i++)
+        r = (r << 15) ^ static_cast<uint64>(m_rand());
+    return r;
+}
+
+unsigned bv_simulator::width(expr * e) const {
+    return m.is_bool(e) ? 1 : m_bv.get_bv_size(e);
+}
+
+void bv_simulator::set_input(expr * t, uint64 const * vals) {
+    SASSERT(!is_simulated(t));
+    m_user_inputs.insert(t, m_user_values.size());
+    m_user_values.append(N, vals);
+    m_inputs.push_back(t);
+}
+
+bool bv_simulator::is_supported(app * a) const {
+    if (!m.is_bool(a) && !(m_bv.is_bv(a) && m_bv.get_bv_size(a) <= 64))
+        return false;
+    if (a->get_num_args() == 0)
+        return m.is_true(a) || m.is_false(a) || m_bv.is_numeral(a);
+    for (expr * arg : *a)
+        if (!m.is_bool(arg) && !(m_bv.is_bv(arg) && m_bv.get_bv_size(arg) <= 64))
+            return false;
+    family_id fid = a->get_family_id();
+    if (fid == m.get_basic_family_id()) {
+        switch (a->get_decl_kind()) {
+        case OP_EQ: case OP_DISTINCT: case OP_ITE: case OP_AND: case OP_OR:
+        case OP_IFF: case OP_XOR: case OP_NOT: case OP_IMPLIES:
+            return true;
+        default:
+            return false;
+        }
+    }
+    if (fid != m_bv.get_fid())
+        return false;
+    switch (a->get_decl_kind()) {
+    case OP_BNEG: case OP_BADD: case OP_BSUB: case OP_BMUL:
+    case OP_BSDIV: case OP_BUDIV: case OP_BSREM: case OP_BUREM: case OP_BSMOD:
+    case OP_BSDIV_I: case OP_BUDIV_I: case OP_BSREM_I: case OP_BUREM_I: case OP_BSMOD_I:
+    case OP_ULEQ: case OP_SLEQ: case OP_UGEQ: case OP_SGEQ:
+    case OP_ULT: case OP_SLT: case OP_UGT: case OP_SGT:
+    case OP_BAND: case OP_BOR: case OP_BNOT: case OP_BXOR:
+    case OP_BNAND: case OP_BNOR: case OP_BXNOR:
+    case OP_CONCAT: case OP_SIGN_EXT: case OP_ZERO_EXT: case OP_EXTRACT: case OP_REPEAT:
+    case OP_BREDOR: case OP_BREDAND: case OP_BCOMP:
+    case OP_BSHL: case OP_BLSHR: case OP_BASHR:
+    case OP_ROTATE_LEFT: case OP_ROTATE_RIGHT:
+    case OP_BIT2BOOL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint64 const * bv_simulator::arg(app * a, unsigned i) const {
+    return get_values(a->get_arg(i));
+}
+
+void bv_simulator::operator()(unsigned num, expr * const * ts) {
+    ptr_vector<expr> todo;
+    for (unsigned i = 0; i < num; i++)
+        todo.push_back(ts[i]);
+    while (!todo.empty()) {
+        expr * e = todo.back();
+        if (is_simulated(e)) {
+            todo.pop_back();
+            continue;
+        }
+        bool visited = true;
+        if (is_app(e) && is_supported(to_app(e))) {
+            for (expr * arg : *to_app(e)) {
+                if (!is_simulated(arg)) {
+                    todo.push_back(arg);
+                    visited = false;
+                }
+            }
+        }
+        if (visited) {
+            simulate(e);
+            todo.pop_back();
+        }
+    }
+}
+
+void bv_simulator::simulate(expr * e) {
+    unsigned idx = m_expr2idx.size();
+    m_expr2idx.insert(e, idx);
+    m_nodes.push_back(e);
+    m_values.resize(m_values.size() + N, 0);
+    uint64 * r = values(idx);
+    unsigned user_idx;
+    bool input = !is_app(e) || !is_supported(to_app(e));
+    m_is_input.push_back(input);
+    if (!input) {
+        eval(to_app(e), r);
+    }
+    else if (m_user_inputs.find(e, user_idx)) {
+        for (unsigned i = 0; i < N; i++)
+            r[i] = m_user_values[user_idx + i];
+    }
+    else {
+        uint64 msk = (m.is_bool(e) || !m_bv.is_bv(e)) ? 1 : mask(m_bv.get_bv_size(e));
+        for (unsigned i = 0; i < N; i++)
+            r[i] = random_word() & msk;
+    }
+}
+
+void bv_simulator::eval(app * a, uint64 * r) {
+    unsigned num = a->get_num_args();
+    unsigned sz  = width(a);
+    uint64 msk   = mask(sz);
+    rational val;
+    unsigned bv_sz;
+    if (m.is_true(a)) {
+        for (unsigned i = 0; i < N; i++) r[i] = 1;
+        return;
+    }
+    if (m.is_false(a)) {
+        for (unsigned i = 0; i < N; i++) r[i] = 0;
+        return;
+    }
+    if (m_bv.is_numeral(a, val, bv_sz)) {
+        SASSERT(val.is_uint64());
+        uint64 v = val.get_uint64();
+        for (unsigned i = 0; i < N; i++) r[i] = v;
+        return;
+    }
+    if (a->get_family_id() == m.get_basic_family_id()) {
+        switch (a->get_decl_kind()) {
+        case OP_EQ:
+        case OP_IFF: {
+            uint64 const * x = arg(a, 0), * y = arg(a, 1);
+            for (unsigned i = 0; i < N; i++) r[i] = x[i] == y[i];
+            return;
+        }
+        case OP_DISTINCT:
+            for (unsigned i = 0; i < N; i++) r[i] = 1;
+            for (unsigned j = 0; j < num; j++)
+                for (unsigned k = j + 1; k < num; k++) {
+                    uint64 const * x = arg(a, j), * y = arg(a, k);
+                    for (unsigned i = 0; i < N; i++) r[i] &= x[i] != y[i];
+                }
+            return;
+        case OP_ITE: {
+            uint64 const * c = arg(a, 0), * x = arg(a, 1), * y = arg(a, 2);
+            for (unsigned i = 0; i < N; i++) r[i] = c[i] ? x[i] : y[i];
+            return;
+        }
+        case OP_AND:
+            for (unsigned i = 0; i < N; i++) r[i] = 1;
+            for (unsigned j = 0; j < num; j++) {
+                uint64 const * x = arg(a, j);
+                for (unsigned i = 0; i < N; i++) r[i] &= x[i];
+            }
+            return;
+        case OP_OR:
+            for (unsigned i = 0; i < N; i++) r[i] = 0;
+            for (unsigned j = 0; j < num; j++) {
+                uint64 const * x = arg(a, j);
+                for (unsigned i = 0; i < N; i++) r[i] |= x[i];
+            }
+            return;
+        case OP_XOR:
+            for (unsigned i = 0; i < N; i++) r[i] = 0;
+            for (unsigned j = 0; j < num; j++) {
+                uint64 const * x = arg(a, j);
+                for (unsigned i = 0; i < N; i++) r[i] ^= x[i];
+            }
+            return;
+        case OP_NOT: {
+            uint64 const * x = arg(a, 0);
+            for (unsigned i = 0; i < N; i++) r[i] = x[i] ^ 1;
+            return;
+        }
+        case OP_IMPLIES: {
+            uint64 const * x = arg(a, 0), * y = arg(a, 1);
+            for (unsigned i = 0; i < N; i++) r[i] = (x[i] ^ 1) | y[i];
+            return;
+        }
+        default:
+            UNREACHABLE();
+        }
+    }
+    SASSERT(a->get_family_id() == m_bv.get_fid());
+    unsigned arg_sz = num > 0 && !m.is_bool(a->get_arg(0)) ? m_bv.get_bv_size(a->get_arg(0)) : 1;
+    uint64 arg_msk  = mask(arg_sz);
+    switch (a->get_decl_kind()) {
+    case OP_BNEG: {
+        uint64 const * x = arg(a, 0);
+        for (unsigned i = 0; i < N; i++) r[i] = (0 - x[i]) & msk;
+        return;
+    }
+    case OP_BADD:
+        for (unsigned i = 0; i < N; i++) r[i] = 0;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            for (unsigned i = 0; i < N; i++) r[i] += x[i];
+        }
+        for (unsigned i = 0; i < N; i++) r[i] &= msk;
+        return;
+    case OP_BSUB: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) r[i] = (x[i] - y[i]) & msk;
+        return;
+    }
+    case OP_BMUL:
+        for (unsigned i = 0; i < N; i++) r[i] = 1;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            for (unsigned i = 0; i < N; i++) r[i] *= x[i];
+        }
+        for (unsigned i = 0; i < N; i++) r[i] &= msk;
+        return;
+    case OP_BUDIV:
+    case OP_BUDIV_I: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) r[i] = udiv(x[i], y[i], msk);
+        return;
+    }
+    case OP_BUREM:
+    case OP_BUREM_I: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) r[i] = urem(x[i], y[i]);
+        return;
+    }
+    case OP_BSDIV:
+    case OP_BSDIV_I: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) {
+            bool sx = msb(x[i], sz), sy = msb(y[i], sz);
+            uint64 ax = sx ? (0 - x[i]) & msk : x[i];
+            uint64 ay = sy ? (0 - y[i]) & msk : y[i];
+            uint64 q  = udiv(ax, ay, msk);
+            r[i] = sx != sy ? (0 - q) & msk : q;
+        }
+        return;
+    }
+    case OP_BSREM:
+    case OP_BSREM_I: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) {
+            bool sx = msb(x[i], sz), sy = msb(y[i], sz);
+            uint64 ax = sx ? (0 - x[i]) & msk : x[i];
+            uint64 ay = sy ? (0 - y[i]) & msk : y[i];
+            uint64 u  = urem(ax, ay);
+            r[i] = sx ? (0 - u) & msk : u;
+        }
+        return;
+    }
+    case OP_BSMOD:
+    case OP_BSMOD_I: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) {
+            bool sx = msb(x[i], sz), sy = msb(y[i], sz);
+            uint64 ax = sx ? (0 - x[i]) & msk : x[i];
+            uint64 ay = sy ? (0 - y[i]) & msk : y[i];
+            uint64 u  = urem(ax, ay);
+            if (u == 0 || sx == sy)
+                r[i] = sx ? (0 - u) & msk : u;
+            else if (sx)
+                r[i] = (y[i] - u) & msk;
+            else
+                r[i] = (u + y[i]) & msk;
+        }
+        return;
+    }
+    case OP_ULEQ: case OP_UGEQ: case OP_ULT: case OP_UGT: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        switch (a->get_decl_kind()) {
+        case OP_ULEQ: for (unsigned i = 0; i < N; i++) r[i] = x[i] <= y[i]; break;
+        case OP_UGEQ: for (unsigned i = 0; i < N; i++) r[i] = x[i] >= y[i]; break;
+        case OP_ULT:  for (unsigned i = 0; i < N; i++) r[i] = x[i] < y[i]; break;
+        default:      for (unsigned i = 0; i < N; i++) r[i] = x[i] > y[i]; break;
+        }
+        return;
+    }
+    case OP_SLEQ: case OP_SGEQ: case OP_SLT: case OP_SGT: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) {
+            int64 sx = to_signed(x[i], arg_sz), sy = to_signed(y[i], arg_sz);
+            switch (a->get_decl_kind()) {
+            case OP_SLEQ: r[i] = sx <= sy; break;
+            case OP_SGEQ: r[i] = sx >= sy; break;
+            case OP_SLT:  r[i] = sx < sy; break;
+            default:      r[i] = sx > sy; break;
+            }
+        }
+        return;
+    }
+    case OP_BAND:
+        for (unsigned i = 0; i < N; i++) r[i] = msk;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            for (unsigned i = 0; i < N; i++) r[i] &= x[i];
+        }
+        return;
+    case OP_BOR:
+    case OP_BNOR:
+        for (unsigned i = 0; i < N; i++) r[i] = 0;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            for (unsigned i = 0; i < N; i++) r[i] |= x[i];
+        }
+        if (a->get_decl_kind() == OP_BNOR)
+            for (unsigned i = 0; i < N; i++) r[i] = ~r[i] & msk;
+        return;
+    case OP_BXOR:
+    case OP_BXNOR:
+        for (unsigned i = 0; i < N; i++) r[i] = 0;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            for (unsigned i = 0; i < N; i++) r[i] ^= x[i];
+        }
+        if (a->get_decl_kind() == OP_BXNOR)
+            for (unsigned i = 0; i < N; i++) r[i] = ~r[i] & msk;
+        return;
+    case OP_BNAND:
+        for (unsigned i = 0; i < N; i++) r[i] = msk;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            for (unsigned i = 0; i < N; i++) r[i] &= x[i];
+        }
+        for (unsigned i = 0; i < N; i++) r[i] = ~r[i] & msk;
+        return;
+    case OP_BNOT: {
+        uint64 const * x = arg(a, 0);
+        for (unsigned i = 0; i < N; i++) r[i] = ~x[i] & msk;
+        return;
+    }
+    case OP_CONCAT:
+        for (unsigned i = 0; i < N; i++) r[i] = 0;
+        for (unsigned j = 0; j < num; j++) {
+            uint64 const * x = arg(a, j);
+            unsigned w = m_bv.get_bv_size(a->get_arg(j));
+            for (unsigned i = 0; i < N; i++) r[i] = w >= 64 ? x[i] : (r[i] << w) | x[i];
+        }
+        return;
+    case OP_ZERO_EXT: {
+        uint64 const * x = arg(a, 0);
+        for (unsigned i = 0; i < N; i++) r[i] = x[i];
+        return;
+    }
+    case OP_SIGN_EXT: {
+        uint64 const * x = arg(a, 0);
+        for (unsigned i = 0; i < N; i++) r[i] = static_cast<uint64>(to_signed(x[i], arg_sz)) & msk;
+        return;
+    }
+    case OP_EXTRACT: {
+        uint64 const * x = arg(a, 0);
+        unsigned lo = m_bv.get_extract_low(a);
+        for (unsigned i = 0; i < N; i++) r[i] = (x[i] >> lo) & msk;
+        return;
+    }
+    case OP_REPEAT: {
+        uint64 const * x = arg(a, 0);
+        unsigned n = sz / arg_sz;
+        for (unsigned i = 0; i < N; i++) {
+            uint64 v = 0;
+            for (unsigned k = 0; k < n; k++)
+                v = arg_sz >= 64 ? x[i] : (v << arg_sz) | x[i];
+            r[i] = v;
+        }
+        return;
+    }
+    case OP_BREDOR: {
+        uint64 const * x = arg(a, 0);
+        for (unsigned i = 0; i < N; i++) r[i] = x[i] != 0;
+        return;
+    }
+    case OP_BREDAND: {
+        uint64 const * x = arg(a, 0);
+        for (unsigned i = 0; i < N; i++) r[i] = x[i] == arg_msk;
+        return;
+    }
+    case OP_BCOMP: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) r[i] = x[i] == y[i];
+        return;
+    }
+    case OP_BSHL: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) r[i] = y[i] >= sz ? 0 : (x[i] << y[i]) & msk;
+        return;
+    }
+    case OP_BLSHR: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) r[i] = y[i] >= sz ? 0 : x[i] >> y[i];
+        return;
+    }
+    case OP_BASHR: {
+        uint64 const * x = arg(a, 0), * y = arg(a, 1);
+        for (unsigned i = 0; i < N; i++) {
+            int64 v = to_signed(x[i], sz);
+            r[i] = static_cast<uint64>(y[i] >= sz ? (v < 0 ? -1 : 0) : v >> y[i]) & msk;
+        }
+        return;
+    }
+    case OP_ROTATE_LEFT:
+    case OP_ROTATE_RIGHT: {
+        uint64 const * x = arg(a, 0);
+        unsigned k = a->get_decl()->get_parameter(0).get_int() % sz;
+        if (a->get_decl_kind() == OP_ROTATE_RIGHT)
+            k = (sz - k) % sz;
+        for (unsigned i = 0; i < N; i++)
+            r[i] = k == 0 ? x[i] : ((x[i] << k) | (x[i] >> (sz - k))) & msk;
+        return;
+    }
+    case OP_BIT2BOOL: {
+        uint64 const * x = arg(a, 0);
+        unsigned k = a->get_decl()->get_parameter(0).get_int();
+        for (unsigned i = 0; i < N; i++) r[i] = (x[i] >> k) & 1;
+        return;
+    }
+    default:
+        UNREACHABLE();
+    }
+}
+
+uint64 const * bv_simulator::get_values(expr * t) const {
+    SASSERT(is_simulated(t));
+    return m_values.c_ptr() + m_expr2idx[t] * N;
+}
+
+unsigned bv_simulator::get_signature(expr * t) const {
+    return string_hash(reinterpret_cast<char const *>(get_values(t)), N * sizeof(uint64), 0);
+}
+
+bool bv_simulator::is_constant(expr * t, uint64 & v) const {
+    if (m_is_input[m_expr2idx[t]])
+        return false;
+    uint64 const * x = get_values(t);
+    for (unsigned i = 1; i < N; i++)
+        if (x[i] != x[0])
+            return false;
+    v = x[0];
+    return true;
+}
+
+void bv_simulator::get_candidate_classes(vector<ptr_vector<expr> > & classes) const {
+    classes.reset();
+    // bucket the terms by sort and signature, then split the buckets by values.
+    u_map<unsigned_vector> buckets;
+    for (auto const & kv : m_expr2idx) {
+        expr * e = kv.m_key;
+        unsigned h = combine_hash(get_signature(e), m.get_sort(e)->get_id());
+        buckets.insert_if_not_there2(h, unsigned_vector())->get_data().m_value.push_back(kv.m_value);
+    }
+    for (auto const & kv : buckets) {
+        unsigned_vector const & b = kv.m_value;
+        if (b.size() < 2)
+            continue;
+        unsigned first = classes.size();
+        for (unsigned idx : b) {
+            expr * e = m_nodes.get(idx);
+            uint64 const * x = get_values(e);
+            bool found = false;
+            for (unsigned c = first; !found && c < classes.size(); c++) {
+                expr * f = classes[c][0];
+                if (m.get_sort(f) != m.get_sort(e))
+                    continue;
+                uint64 const * y = get_values(f);
+                found = memcmp(x, y, N * sizeof(uint64)) == 0;
+                if (found)
+                    classes[c].push_back(e);
+            }
+            if (!found) {
+                classes.push_back(ptr_vector<expr>());
+                classes.back().push_back(e);
+            }
+        }
+    }
+    unsigned j = 0;
+    for (unsigned i = 0; i < classes.size(); i++)
+        if (classes[i].size() > 1)
+            classes[j++] = classes[i];
+    classes.shrink(j);
+}
@@ -0,0 +1,98 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    bv_simulator.h
+
+Abstract:
+
+    Bit-parallel simulation of Boolean and bit-vector expressions.
+
+    Every expression is evaluated on a batch of num_lanes input vectors at once.
+    The value of a bit-vector term of width at most 64 in one vector is stored in a
+    machine word, so every operation is a loop of native word operations over the
+    lanes. Terms that cannot be simulated (wider bit-vectors, uninterpreted functions,
+    other theories) are treated as inputs, and get random values as the uninterpreted
+    constants do.
+
+    The values are used as signatures: two terms with different values are not
+    equivalent, and terms with equal values are candidates for equivalence.
+
+Notes:
+
+--*/
+#ifndef BV_SIMULATOR_H_
+#define BV_SIMULATOR_H_
+
+#include "ast/bv_decl_plugin.h"
+#include "util/obj_hashtable.h"
+
+class bv_simulator {
+public:
+    static const unsigned num_lanes = 64;
+
+private:
+    ast_manager &         m;
+    bv_util               m_bv;
+    random_gen            m_rand;
+    expr_ref_vector       m_nodes;       // simulated terms
+    obj_map<expr, unsigned> m_expr2idx;  // term -> position in m_nodes
+    svector<uint64>       m_values;      // num_lanes values per term
+    svector<bool>         m_is_input;
+    expr_ref_vector       m_inputs;      // terms given to set_input
+    obj_map<expr, unsigned> m_user_inputs; // term -> position in m_user_values
+    svector<uint64>       m_user_values;
+
+    uint64 random_word();
+    unsigned width(expr * e) const;
+    bool is_supported(app * a) const;
+    void simulate(expr * e);
+    void eval(app * a, uint64 * r);
+    uint64 * values(unsigned idx) { return m_values.c_ptr() + idx * num_lanes; }
+    uint64 const * arg(app * a, unsigned i) const;
+
+public:
+    bv_simulator(ast_manager & m, unsigned seed = 0);
+
+    /**
+       \brief Fix the values of the input \c t (an uninterpreted constant) in all lanes.
+       The value in lane i is vals[i]. It must be set before \c t is simulated.
+    */
+    void set_input(expr * t, uint64 const * vals);
+
+    /**
+       \brief Simulate the given terms and their subterms.
+       Terms that were already simulated keep their values.
+    */
+    void operator()(unsigned num, expr * const * ts);
+    void operator()(expr * t) { operator()(1, &t); }
+
+    bool is_simulated(expr * t) const { return m_expr2idx.contains(t); }
+
+    /**
+       \brief Return the values of t in all lanes. Booleans are 0 or 1.
+    */
+    uint64 const * get_values(expr * t) const;
+
+    /**
+       \brief Return a hash of the values of t.
+    */
+    unsigned get_signature(expr * t) const;
+
+    /**
+       \brief Return true if t has the same value v in all lanes.
+       Inputs are never constant.
+    */
+    bool is_constant(expr * t, uint64 & v) const;
+
+    /**
+       \brief Store in classes the sets of simulated terms of the same sort that have the
+       same values in all lanes. Only sets with at least two terms are returned.
+    */
+    void get_candidate_classes(vector<ptr_vector<expr> > & classes) const;
+
+    void reset();
+};
+
+#endif
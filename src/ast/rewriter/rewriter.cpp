@@ -19,6 +19,7 @@ Notes:
 #include "ast/rewriter/rewriter_def.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_smt2_pp.h"
+#include "util/statistics.h"
 
 void rewriter_core::init_cache_stack() {
     SASSERT(m_cache_stack.empty());
@@ -54,6 +55,8 @@ void rewriter_core::cache_result(expr * k, expr * v) {
     SASSERT(m().get_sort(k) == m().get_sort(v));
 
     m_cache->insert(k, v);
+    if (m_persistent_cache && m_scopes.empty())
+        m_persistent_cache->insert(k, v);
 #if 0
     static unsigned num_cached = 0;
     num_cached ++;
@@ -73,6 +76,34 @@ unsigned rewriter_core::get_cache_size() const {
     return m_cache->size();
 }
 
+rewriter_cache::rewriter_cache(ast_manager & m, unsigned max_size):
+    m_cache(m, max_size / 2),
+    m_max_size(max_size),
+    m_hits(0),
+    m_misses(0) {
+}
+
+expr * rewriter_cache::find(expr * k) {
+    expr * r = m_cache.find(k);
+    if (r)
+        m_hits++;
+    else
+        m_misses++;
+    return r;
+}
+
+void rewriter_cache::insert(expr * k, expr * v) {
+    if (m_cache.size() >= m_max_size)
+        m_cache.reset();
+    m_cache.insert(k, v);
+}
+
+void rewriter_cache::collect_statistics(statistics & st) const {
+    st.update("rewriter cache hits", m_hits);
+    st.update("rewriter cache misses", m_misses);
+    st.update("rewriter cache size", m_cache.size());
+}
+
 void rewriter_core::reset_cache() {
     m_cache = m_cache_stack[0];
     m_cache->reset();
@@ -174,6 +205,7 @@ rewriter_core::rewriter_core(ast_manager & m, bool proof_gen):
     m_manager(m),
     m_proof_gen(proof_gen),
     m_cancel_check(true),
+    m_persistent_cache(nullptr),
     m_result_stack(m),
     m_result_pr_stack(m),
     m_num_qvars(0) {
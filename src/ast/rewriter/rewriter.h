@@ -23,6 +23,34 @@ Notes:
 #include "ast/rewriter/rewriter_types.h"
 #include "ast/act_cache.h"
 
+class statistics;
+
+/**
+   \brief Size-bounded cache of rewriting results that outlives the
+   rewriter calls (and the reset/cleanup) of the rewriter using it.
+
+   Entries that are never hit are evicted first (see act_cache).
+   When the cache reaches its maximal size it is flushed.
+
+   The client is responsible for flushing the cache when the
+   configuration of the rewriter changes.
+*/
+class rewriter_cache {
+    act_cache m_cache;
+    unsigned  m_max_size;
+    unsigned  m_hits;
+    unsigned  m_misses;
+public:
+    rewriter_cache(ast_manager & m, unsigned max_size);
+    expr * find(expr * k);
+    void insert(expr * k, expr * v);
+    void reset() { m_cache.reset(); }
+    unsigned size() const { return m_cache.size(); }
+    unsigned max_size() const { return m_max_size; }
+    void collect_statistics(statistics & st) const;
+    void reset_statistics() { m_hits = 0; m_misses = 0; }
+};
+
 /**
    \brief Common infrastructure for AST rewriters.
 */
@@ -52,6 +80,10 @@ protected:
     typedef act_cache          cache;
     ptr_vector<cache>          m_cache_stack;
     cache *                    m_cache; // current cache.
+    // When not null, results of shared subterms outside of binders are also stored in
+    // and retrieved from m_persistent_cache. Subclasses set it only when these results
+    // do not depend on bindings, substitutions or proof generation. Not owned.
+    rewriter_cache *           m_persistent_cache;
     svector<frame>             m_frame_stack;
     expr_ref_vector            m_result_stack;
 
@@ -91,7 +123,12 @@ protected:
     void del_cache_stack();
     void reset_cache();
     void cache_result(expr * k, expr * v);
-    expr * get_cached(expr * k) const { return m_cache->find(k); } 
+    expr * get_cached(expr * k) const { 
+        expr * r = m_cache->find(k);
+        if (r == nullptr && m_persistent_cache && m_scopes.empty())
+            r = m_persistent_cache->find(k);
+        return r;
+    } 
 
     void cache_result(expr * k, expr * v, proof * pr);
     proof * get_cached_pr(expr * k) const { return static_cast<proof*>(m_cache_pr->find(k)); } 
@@ -722,11 +722,52 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
     void set_solver(expr_solver* solver) {
         m_cfg.m_seq_rw.set_solver(solver);
     }
+
+    void updt_params(params_ref const & p) {
+        m_cfg.updt_params(p);
+        // results cached between calls were computed with the old configuration.
+        reset_cache();
+    }
+
+    using rewriter_tpl<th_rewriter_cfg>::operator();
+
+    void operator()(expr * t, expr_ref & result, proof_ref & result_pr, rewriter_cache & c) {
+        SASSERT(!m_proof_gen);
+        expr * r = c.find(t);
+        if (r) {
+            m_num_steps = 0;
+            result = r;
+            return;
+        }
+        flet<rewriter_cache*> _c(m_persistent_cache, &c);
+        rewriter_tpl<th_rewriter_cfg>::operator()(t, result, result_pr);
+        c.insert(t, result);
+    }
 };
 
 th_rewriter::th_rewriter(ast_manager & m, params_ref const & p):
-    m_params(p) {
+    m_params(p),
+    m_cache(nullptr) {
     m_imp = alloc(imp, m, p);
+    init_cache();
+}
+
+void th_rewriter::init_cache() {
+    // cached results are only valid for the configuration they were computed with.
+    unsigned sz = rewriter_params(m_params).persistent_cache();
+    if (m_cache && m_cache->max_size() == sz) {
+        m_cache->reset();
+        return;
+    }
+    dealloc(m_cache);
+    m_cache = sz > 0 ? alloc(rewriter_cache, m(), sz) : nullptr;
+}
+
+bool th_rewriter::use_cache() const {
+    if (!m_cache || m().proofs_enabled())
+        return false;
+    expr_substitution * s = m_imp->cfg().m_subst;
+    return s == nullptr || s->empty();
 }
 
 ast_manager & th_rewriter::m() const {
@@ -735,7 +776,8 @@ ast_manager & th_rewriter::m() const {
 
 void th_rewriter::updt_params(params_ref const & p) {
     m_params = p;
-    m_imp->cfg().updt_params(p);
+    m_imp->updt_params(p);
+    init_cache();
 }
 
 void th_rewriter::get_param_descrs(param_descrs & r) {
@@ -748,6 +790,7 @@ void th_rewriter::get_param_descrs(param_descrs & r) {
 
 th_rewriter::~th_rewriter() {
     dealloc(m_imp);
+    dealloc(m_cache);
 }
 
 unsigned th_rewriter::get_cache_size() const {
@@ -772,19 +815,25 @@ void th_rewriter::reset() {
 
 void th_rewriter::operator()(expr_ref & term) {
     expr_ref result(term.get_manager());
-    m_imp->operator()(term, result);
+    operator()(term, result);
     term = result;
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result) {
-    m_imp->operator()(t, result);
+    proof_ref pr(m());
+    operator()(t, result, pr);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
-    m_imp->operator()(t, result, result_pr);
+    scoped_memory_tag _mt("rewriter");
+    if (use_cache())
+        m_imp->operator()(t, result, result_pr, *m_cache);
+    else
+        m_imp->operator()(t, result, result_pr);
 }
 
 void th_rewriter::operator()(expr * n, unsigned num_bindings, expr * const * bindings, expr_ref & result) {
+    scoped_memory_tag _mt("rewriter");
     m_imp->operator()(n, num_bindings, bindings, result);
 }
 
@@ -811,3 +860,13 @@ expr_ref th_rewriter::mk_app(func_decl* f, unsigned num_args, expr* const* args)
 void th_rewriter::set_solver(expr_solver* solver) {
     m_imp->set_solver(solver);
 }
+
+void th_rewriter::collect_statistics(statistics & st) const {
+    if (m_cache)
+        m_cache->collect_statistics(st);
+}
+
+void th_rewriter::reset_statistics() {
+    if (m_cache)
+        m_cache->reset_statistics();
+}
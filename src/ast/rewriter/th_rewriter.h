@@ -27,10 +27,17 @@ class expr_substitution;
 
 class expr_solver;
 
+class rewriter_cache;
+
+class statistics;
+
 class th_rewriter {
     struct     imp;
     imp *      m_imp;
     params_ref m_params;
+    rewriter_cache * m_cache; // persistent cache, survives reset() and cleanup()
+    void init_cache();
+    bool use_cache() const;
 public:
     th_rewriter(ast_manager & m, params_ref const & p = params_ref());
     ~th_rewriter();
@@ -63,6 +70,10 @@ public:
 
     void set_solver(expr_solver* solver);
 
+    // statistics of the persistent cache (see rewriter.persistent_cache)
+    void collect_statistics(statistics & st) const;
+    void reset_statistics();
+
 };
 
 #endif
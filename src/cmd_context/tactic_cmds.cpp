@@ -97,9 +97,11 @@ void help_tactic(cmd_context & ctx) {
     buf << "- (or-else <tactic>+) tries the given tactics in sequence until one of them succeeds (i.e., the first that doesn't fail).\n";
     buf << "- (par-or <tactic>+) executes the given tactics in parallel until one of them succeeds (i.e., the first that doesn't fail).\n";
     buf << "- (par-then <tactic1> <tactic2>) executes tactic1 and then tactic2 to every subgoal produced by tactic1. All subgoals are processed in parallel.\n";
+    buf << "- (split-components <tactic>) applies the given tactic to every group of assertions that do not share uninterpreted symbols with the others. The groups are processed in parallel.\n";
     buf << "- (try-for <tactic> <num>) executes the given tactic for at most <num> milliseconds, it fails if the execution takes more than <num> milliseconds.\n";
     buf << "- (if <probe> <tactic> <tactic>) if <probe> evaluates to true, then execute the first tactic. Otherwise execute the second.\n";
     buf << "- (when <probe> <tactic>) shorthand for (if <probe> <tactic> skip).\n";
+    buf << "- (select-max (<probe> <tactic>)+) execute the tactic whose probe has the largest value, the first one on ties.\n";
     buf << "- (fail-if <probe>) fail if <probe> evaluates to true.\n";
     buf << "- (using-params <tactic> <attribute>*) executes the given tactic using the given attributes, where <attribute> ::= <keyword> <value>. ! is a syntax sugar for using-params.\n";
     buf << "builtin tactics:\n";
@@ -470,6 +472,15 @@ static tactic * mk_par_then(cmd_context & ctx, sexpr * n) {
     return par_and_then(args.size(), args.c_ptr());
 }
 
+static tactic * mk_split_components(cmd_context & ctx, sexpr * n) {
+    SASSERT(n->is_composite());
+    unsigned num_children = n->get_num_children();
+    if (num_children != 2)
+        throw cmd_exception("invalid split-components combinator, one argument expected", n->get_line(), n->get_pos());
+    tactic * t = sexpr2tactic(ctx, n->get_child(1));
+    return split_components(t);
+}
+
 static tactic * mk_try_for(cmd_context & ctx, sexpr * n) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
@@ -565,6 +576,23 @@ static tactic * mk_if(cmd_context & ctx, sexpr * n) {
     return cond(c.get(), t.get(), e.get());
 }
 
+static tactic * mk_select_max(cmd_context & ctx, sexpr * n) {
+    SASSERT(n->is_composite());
+    unsigned num_children = n->get_num_children();
+    if (num_children < 2)
+        throw cmd_exception("invalid select-max combinator, at least one argument expected", n->get_line(), n->get_pos());
+    sref_buffer<probe> scores;
+    sref_buffer<tactic> ts;
+    for (unsigned i = 1; i < num_children; i++) {
+        sexpr * c = n->get_child(i);
+        if (!c->is_composite() || c->get_num_children() != 2)
+            throw cmd_exception("invalid select-max combinator, (<probe> <tactic>) pair expected", c->get_line(), c->get_pos());
+        scores.push_back(sexpr2probe(ctx, c->get_child(0)));
+        ts.push_back(sexpr2tactic(ctx, c->get_child(1)));
+    }
+    return select_max(ts.size(), scores.c_ptr(), ts.c_ptr());
+}
+
 static tactic * mk_fail_if(cmd_context & ctx, sexpr * n) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
@@ -692,10 +720,14 @@ tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
             return mk_par_then(ctx, n);
         else if (cmd_name == "try-for")
             return mk_try_for(ctx, n);
+        else if (cmd_name == "split-components")
+            return mk_split_components(ctx, n);
         else if (cmd_name == "repeat")
             return mk_repeat(ctx, n);
         else if (cmd_name == "if" || cmd_name == "ite" || cmd_name == "cond")
             return mk_if(ctx, n);
+        else if (cmd_name == "select-max")
+            return mk_select_max(ctx, n);
         else if (cmd_name == "fail-if")
             return mk_fail_if(ctx, n);
         else if (cmd_name == "fail-if-branching")
@@ -785,7 +817,7 @@ probe * sexpr2probe(cmd_context & ctx, sexpr * n) {
     else if (n->is_numeral()) {
         rational const & v = n->get_numeral();
         if (!v.is_int32())
-            throw cmd_exception("invalid probe, constant is too big to fit in a fixed size integer", n->get_line(), n->get_pos());
+            return mk_const_probe(v.get_double());
         return mk_const_probe(static_cast<int>(v.get_int64()));
     }
     else if (n->is_composite()) {
@@ -382,11 +382,35 @@ namespace opt {
         return out;
     }
 
+    bool optsmt::is_saturated(unsigned idx) const {
+        return m_lower[idx].is_pos() && !m_lower[idx].is_finite();
+    }
+
+    /**
+       Maximize the objectives in the current state of the solver.
+       Objectives whose lower bound is already unbounded keep their
+       value, model and (false) blocker from the round that established it.
+       Re-maximizing them costs a simplex pass each and possibly an
+       extra check, which dominates box optimization with many objectives.
+    */
+    void optsmt::maximize_objectives(expr_ref_vector& disj) {
+        expr_ref blocker(m);
+        for (unsigned i = 0; i < m_lower.size(); ++i) {
+            if (is_saturated(i)) {
+                disj.push_back(m.mk_false());
+            }
+            else {
+                m_s->maximize_objective(i, blocker);
+                disj.push_back(blocker);
+            }
+        }
+    }
+
     expr_ref optsmt::update_lower() {
         expr_ref_vector disj(m);
         m_s->get_model(m_model);
         m_s->get_labels(m_labels);
-        m_s->maximize_objectives(disj);
+        maximize_objectives(disj);
         set_max(m_lower, m_s->get_objective_values(), disj);
         TRACE("opt", model_pp(tout << m_lower << "\n", *m_model););
         IF_VERBOSE(2, verbose_stream() << "(optsmt.lower " << m_lower << ")\n";);
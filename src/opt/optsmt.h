@@ -88,6 +88,10 @@ namespace opt {
 
         void set_max(vector<inf_eps>& dst, vector<inf_eps> const& src, expr_ref_vector& fmls);
 
+        bool is_saturated(unsigned idx) const;
+
+        void maximize_objectives(expr_ref_vector& disj);
+
         expr_ref update_lower();
 
         void update_lower_lex(unsigned idx, inf_eps const& r, bool is_maximize);
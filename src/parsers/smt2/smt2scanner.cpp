@@ -21,21 +21,14 @@ Revision History:
 
 namespace smt2 {
 
-    void scanner::next() {
-        if (m_cache_input)
-            m_cache.push_back(m_curr);
-        SASSERT(!m_at_eof);
+    void scanner::next_core() {
         if (m_interactive) {
             m_curr = m_stream.get();
             if (m_stream.eof())
                 m_at_eof = true;
         }
-        else if (m_bpos < m_bend) {
-            m_curr = m_buffer[m_bpos];
-            m_bpos++;
-        }
         else {
-            m_stream.read(m_buffer, SCANNER_BUFFER_SIZE);
+            m_stream.read(m_buffer.c_ptr(), SCANNER_BUFFER_SIZE);
             m_bend = static_cast<unsigned>(m_stream.gcount());
             m_bpos = 0;
             if (m_bpos == m_bend) {
@@ -49,6 +42,37 @@ namespace smt2 {
         m_spos++;
     }
 
+    /**
+       \brief Move over curr() and the characters in the run that follows it
+       in the buffer, where the run consists of the characters c with
+       in_run[c]. curr() becomes the last character of the run, so the
+       caller still has to process it with next(). The characters passed
+       over are appended to m_string if save is true.
+
+       This has the same effect as calling next() for each character, but
+       runs of symbols, white space and comments are copied in one go.
+    */
+    void scanner::skip_run(bool const * in_run, bool save) {
+        unsigned end = m_bpos;
+        while (end < m_bend && in_run[static_cast<unsigned char>(m_buffer[end])])
+            ++end;
+        if (end == m_bpos)
+            return;
+        char const * begin = m_buffer.c_ptr() + m_bpos;
+        unsigned n = end - m_bpos - 1;
+        if (m_cache_input) {
+            m_cache.push_back(m_curr);
+            m_cache.append(n, begin);
+        }
+        if (save) {
+            m_string.push_back(m_curr);
+            m_string.append(n, begin);
+        }
+        m_curr  = m_buffer[end - 1];
+        m_spos += end - m_bpos;
+        m_bpos  = end;
+    }
+
     void scanner::read_comment() {
         SASSERT(curr() == ';');
         next();
@@ -61,6 +85,7 @@ namespace smt2 {
                 next();
                 return;
             }
+            skip_run(m_comment_char, false);
             next();
         }
     }
@@ -94,9 +119,9 @@ namespace smt2 {
     scanner::token scanner::read_symbol_core() {
         while (!m_at_eof) {
             char c = curr();
-            signed char n = m_normalized[static_cast<unsigned char>(c)];
-            if (n == 'a' || n == '0' || n == '-') {
-                m_string.push_back(c);
+            if (m_symbol_char[static_cast<unsigned char>(c)]) {
+                skip_run(m_symbol_char, true);
+                m_string.push_back(curr());
                 next();
             }
             else {
@@ -117,19 +142,48 @@ namespace smt2 {
         return read_symbol_core();
     }
 
+    /**
+       \brief r := r * 10^num_digits + digits
+    */
+    static void add_decimal_digits(rational & r, uint64 digits, unsigned num_digits) {
+        if (num_digits > 0) {
+            r *= rational(10).expt(num_digits);
+            r += rational(digits, rational::ui64());
+        }
+    }
+
+    /**
+       \brief r := r * 2^num_bits + digits
+    */
+    static void add_binary_digits(rational & r, uint64 digits, unsigned num_bits) {
+        if (num_bits > 0) {
+            r *= rational::power_of_two(num_bits);
+            r += rational(digits, rational::ui64());
+        }
+    }
+
     scanner::token scanner::read_number() {
         SASSERT('0' <= curr() && curr() <= '9');
-        rational q(1);
-        m_number = rational(curr() - '0');
-        next();
+        // Digits are collected in machine words and only moved into
+        // m_number when a word is full.
+        uint64 digits = 0;
+        unsigned num_digits = 0;
+        unsigned num_frac_digits = 0;
+        m_number = rational::zero();
         bool is_float = false;
 
         while (!m_at_eof) {
             char c = curr();
             if ('0' <= c && c <= '9') {
-                m_number = rational(10)*m_number + rational(c - '0');
+                if (num_digits == 18) {
+                    add_decimal_digits(m_number, digits, num_digits);
+                    digits = 0;
+                    num_digits = 0;
+                }
+                digits = 10*digits + (c - '0');
+                num_digits++;
                 if (is_float)
-                    q *= rational(10);
+                    num_frac_digits++;
                 next();
             }
             else if (c == '.') {
@@ -142,8 +196,9 @@ namespace smt2 {
                 break;
             }
         }
-        if (is_float)
-            m_number /= q;
+        add_decimal_digits(m_number, digits, num_digits);
+        if (is_float && num_frac_digits > 0)
+            m_number /= rational(10).expt(num_frac_digits);
         TRACE("scanner", tout << "new number: " << m_number << "\n";);
         return is_float ? FLOAT_TOKEN : INT_TOKEN;
     }
@@ -191,29 +246,37 @@ namespace smt2 {
         SASSERT(curr() == '#');
         next();
         char c = curr();
+        uint64 digits = 0;
+        unsigned num_bits = 0;
         if (c == 'x') {
             next();
             c = curr();
             m_number  = rational(0);
             m_bv_size = 0;
             while (true) {
-                if ('0' <= c && c <= '9') {
-                    m_number *= rational(16);
-                    m_number += rational(c - '0');
+                unsigned d;
+                if (!m_at_eof && '0' <= c && c <= '9') {
+                    d = c - '0';
                 }
-                else if ('a' <= c && c <= 'f') {
-                    m_number *= rational(16);
-                    m_number += rational(10 + (c - 'a'));
+                else if (!m_at_eof && 'a' <= c && c <= 'f') {
+                    d = 10 + (c - 'a');
                 }
-                else if ('A' <= c && c <= 'F') {
-                    m_number *= rational(16);
-                    m_number += rational(10 + (c - 'A'));
+                else if (!m_at_eof && 'A' <= c && c <= 'F') {
+                    d = 10 + (c - 'A');
                 }
                 else {
                     if (m_bv_size == 0)
                         throw scanner_exception("invalid empty bit-vector literal", m_line, m_spos);
+                    add_binary_digits(m_number, digits, num_bits);
                     return BV_TOKEN;
                 }
+                if (num_bits == 64) {
+                    add_binary_digits(m_number, digits, num_bits);
+                    digits = 0;
+                    num_bits = 0;
+                }
+                digits = (digits << 4) | d;
+                num_bits += 4;
                 m_bv_size += 4;
                 next();
                 c = curr();
@@ -224,15 +287,21 @@ namespace smt2 {
             c = curr();
             m_number  = rational(0);
             m_bv_size = 0;
-            while (c == '0' || c == '1') {
-                m_number *= rational(2);
-                m_number += rational(c - '0');
+            while (!m_at_eof && (c == '0' || c == '1')) {
+                if (num_bits == 64) {
+                    add_binary_digits(m_number, digits, num_bits);
+                    digits = 0;
+                    num_bits = 0;
+                }
+                digits = (digits << 1) | static_cast<unsigned>(c - '0');
+                num_bits++;
                 m_bv_size++;
                 next();
                 c = curr();
             }
             if (m_bv_size == 0)
                 throw scanner_exception("invalid empty bit-vector literal", m_line, m_spos);
+            add_binary_digits(m_number, digits, num_bits);
             return BV_TOKEN;
         }
         else {
@@ -289,6 +358,15 @@ namespace smt2 {
         m_normalized[static_cast<int>('.')] = 'a';
         m_normalized[static_cast<int>('?')] = 'a';
         m_normalized[static_cast<int>('/')] = 'a';
+
+        for (int i = 0; i < 256; ++i) {
+            signed char n = m_normalized[i];
+            m_symbol_char[i]  = n == 'a' || n == '0' || n == '-';
+            m_space_char[i]   = n == ' ';
+            m_comment_char[i] = i != '\n';
+        }
+        if (!m_interactive)
+            m_buffer.resize(SCANNER_BUFFER_SIZE);
         next();
     }
 
@@ -302,6 +380,7 @@ namespace smt2 {
 
             switch (m_normalized[(unsigned char) c]) {
             case ' ':
+                skip_run(m_space_char, false);
                 next();
                 break;
             case '\n':
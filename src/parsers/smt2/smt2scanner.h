@@ -44,8 +44,12 @@ namespace smt2 {
         unsigned           m_bv_size;
         // end of data
         signed char        m_normalized[256];
-#define SCANNER_BUFFER_SIZE 1024
-        char               m_buffer[SCANNER_BUFFER_SIZE];
+        // character classes used to consume runs of buffered characters at once
+        bool               m_symbol_char[256];
+        bool               m_space_char[256];
+        bool               m_comment_char[256];
+#define SCANNER_BUFFER_SIZE (1 << 16)
+        svector<char>      m_buffer;
         unsigned           m_bpos;
         unsigned           m_bend;
         svector<char>      m_string;
@@ -59,7 +63,21 @@ namespace smt2 {
         
         char curr() const { return m_curr; }
         void new_line() { m_line++; m_spos = 0; }
-        void next();
+        void next() {
+            if (m_cache_input)
+                m_cache.push_back(m_curr);
+            SASSERT(!m_at_eof);
+            if (m_bpos < m_bend) {
+                m_curr = m_buffer[m_bpos];
+                m_bpos++;
+                m_spos++;
+            }
+            else {
+                next_core();
+            }
+        }
+        void next_core();
+        void skip_run(bool const * in_run, bool save);
         
     public:
         
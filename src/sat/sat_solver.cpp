@@ -21,6 +21,7 @@ Revision History:
 #include "util/luby.h"
 #include "util/trace.h"
 #include "util/max_cliques.h"
+#include "util/z3_omp.h"
 
 // define to update glue during propagation
 #define UPDATE_GLUE
@@ -721,6 +722,7 @@ namespace sat {
     //
     // -----------------------
     lbool solver::check(unsigned num_lits, literal const* lits) {
+        scoped_memory_tag _mt("sat");
         pop_to_base_level();
         IF_VERBOSE(2, verbose_stream() << "(sat.sat-solver)\n";);
         SASSERT(scope_lvl() == 0);
@@ -803,7 +805,8 @@ namespace sat {
     };
 
     lbool solver::check_par(unsigned num_lits, literal const* lits) {
-        int num_threads = static_cast<int>(m_config.m_num_parallel);
+        scoped_omp_threads threads(m_config.m_num_parallel);
+        int num_threads = threads.get();
         int num_extra_solvers = num_threads - 1;
         scoped_limits scoped_rlimit(rlimit());
         vector<reslimit> rlims(num_extra_solvers);
@@ -827,7 +830,7 @@ namespace sat {
         par_exception_kind ex_kind = DEFAULT_EX;
         unsigned error_code = 0;
         lbool result = l_undef;
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(num_threads)
         for (int i = 0; i < num_threads; ++i) {
             try {
                 lbool r = l_undef;
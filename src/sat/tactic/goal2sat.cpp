@@ -57,10 +57,15 @@ struct goal2sat::imp {
     dep2asm_map &               m_dep2asm;
     sat::bool_var               m_true;
     bool                        m_ite_extra;
+    bool                        m_cnf_polarity;
     unsigned long long          m_max_memory;
     expr_ref_vector             m_trail;
     expr_ref_vector             m_interpreted_atoms;
     bool                        m_default_external;
+    // polarity of the Boolean gates in the formulas being converted.
+    enum { POL_POS = 1, POL_NEG = 2, POL_BOTH = 3 };
+    obj_map<app, unsigned>      m_pol;
+    ptr_vector<app>             m_pol_todo;
     
     imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map, dep2asm_map& dep2asm, bool default_external):
         m(_m),
@@ -76,6 +81,7 @@ struct goal2sat::imp {
         
     void updt_params(params_ref const & p) {
         m_ite_extra       = p.get_bool("ite_extra", true);
+        m_cnf_polarity    = p.get_bool("cnf_polarity", true);
         m_max_memory      = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
     }
 
@@ -113,6 +119,67 @@ struct goal2sat::imp {
         return m_true;
     }
 
+    static unsigned flip_pol(unsigned p) {
+        return ((p & POL_POS) ? POL_NEG : 0) | ((p & POL_NEG) ? POL_POS : 0);
+    }
+
+    void add_pol(expr * t, unsigned p) {
+        if (!is_app(t) || to_app(t)->get_family_id() != m.get_basic_family_id())
+            return;
+        unsigned & curr = m_pol.insert_if_not_there2(to_app(t), 0)->get_data().m_value;
+        if ((curr | p) == curr)
+            return;
+        curr |= p;
+        m_pol_todo.push_back(to_app(t));
+    }
+
+    /**
+       \brief Propagate the polarities of the formulas added with add_pol to their
+       sub-formulas. A gate that only occurs positively (negatively) needs only
+       the clauses stating that it implies (is implied by) its definition.
+    */
+    void propagate_pol() {
+        while (!m_pol_todo.empty()) {
+            app * t = m_pol_todo.back();
+            m_pol_todo.pop_back();
+            unsigned p = m_pol.find(t);
+            unsigned num = t->get_num_args();
+            switch (t->get_decl_kind()) {
+            case OP_NOT:
+                add_pol(t->get_arg(0), flip_pol(p));
+                break;
+            case OP_OR:
+            case OP_AND:
+                for (unsigned i = 0; i < num; ++i)
+                    add_pol(t->get_arg(i), p);
+                break;
+            case OP_ITE:
+                if (m.is_bool(t->get_arg(1))) {
+                    add_pol(t->get_arg(0), POL_BOTH);
+                    add_pol(t->get_arg(1), p);
+                    add_pol(t->get_arg(2), p);
+                }
+                break;
+            case OP_IFF:
+            case OP_EQ:
+                if (m.is_bool(t->get_arg(0))) {
+                    add_pol(t->get_arg(0), POL_BOTH);
+                    add_pol(t->get_arg(1), POL_BOTH);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    unsigned get_pol(app * t) const {
+        unsigned p = POL_BOTH;
+        if (m_cnf_polarity)
+            m_pol.find(t, p);
+        return p;
+    }
+
     void convert_atom(expr * t, bool root, bool sign) {
         SASSERT(m.is_bool(t));
         sat::literal  l;
@@ -223,16 +290,21 @@ struct goal2sat::imp {
             sat::bool_var k = m_solver.mk_var();
             sat::literal  l(k, false);
             m_cache.insert(t, l);
+            unsigned pol = get_pol(t);
+            unsigned old_sz = m_result_stack.size() - num;
             sat::literal * lits = m_result_stack.end() - num;
-            for (unsigned i = 0; i < num; i++) {
-                mk_clause(~lits[i], l);
-            }
-            m_result_stack.push_back(~l);
-            lits = m_result_stack.end() - num - 1;
-            // remark: mk_clause may perform destructive updated to lits.
-            // I have to execute it after the binary mk_clause above.
-            mk_clause(num+1, lits);
-            unsigned old_sz = m_result_stack.size() - num - 1;
+            if (pol & POL_NEG) {
+                for (unsigned i = 0; i < num; i++) {
+                    mk_clause(~lits[i], l);
+                }
+            }
+            if (pol & POL_POS) {
+                m_result_stack.push_back(~l);
+                lits = m_result_stack.end() - num - 1;
+                // remark: mk_clause may perform destructive updated to lits.
+                // I have to execute it after the binary mk_clause above.
+                mk_clause(num+1, lits);
+            }
             m_result_stack.shrink(old_sz);
             if (sign)
                 l.neg();
@@ -262,19 +334,24 @@ struct goal2sat::imp {
             sat::bool_var k = m_solver.mk_var();
             sat::literal  l(k, false);
             m_cache.insert(t, l);
+            unsigned pol = get_pol(t);
+            unsigned old_sz = m_result_stack.size() - num;
             // l => /\ lits
             sat::literal * lits = m_result_stack.end() - num;
-            for (unsigned i = 0; i < num; i++) {
-                mk_clause(~l, lits[i]);
+            if (pol & POL_POS) {
+                for (unsigned i = 0; i < num; i++) {
+                    mk_clause(~l, lits[i]);
+                }
             }
             // /\ lits => l
-            for (unsigned i = 0; i < num; ++i) {
-                m_result_stack[m_result_stack.size() - num + i].neg();
+            if (pol & POL_NEG) {
+                for (unsigned i = 0; i < num; ++i) {
+                    m_result_stack[old_sz + i].neg();
+                }
+                m_result_stack.push_back(l);
+                lits = m_result_stack.end() - num - 1;
+                mk_clause(num+1, lits);
             }
-            m_result_stack.push_back(l);
-            lits = m_result_stack.end() - num - 1;
-            mk_clause(num+1, lits);
-            unsigned old_sz = m_result_stack.size() - num - 1;
             m_result_stack.shrink(old_sz);
             if (sign)
                 l.neg();
@@ -306,13 +383,20 @@ struct goal2sat::imp {
             sat::bool_var k = m_solver.mk_var();
             sat::literal  l(k, false);
             m_cache.insert(n, l);
-            mk_clause(~l, ~c, t);
-            mk_clause(~l,  c, e);
-            mk_clause(l,  ~c, ~t);
-            mk_clause(l,   c, ~e);
+            unsigned pol = get_pol(n);
+            if (pol & POL_POS) {
+                mk_clause(~l, ~c, t);
+                mk_clause(~l,  c, e);
+            }
+            if (pol & POL_NEG) {
+                mk_clause(l,  ~c, ~t);
+                mk_clause(l,   c, ~e);
+            }
             if (m_ite_extra) {
-                mk_clause(~t, ~e, l);
-                mk_clause(t,  e, ~l);
+                if (pol & POL_NEG) 
+                    mk_clause(~t, ~e, l);
+                if (pol & POL_POS) 
+                    mk_clause(t,  e, ~l);
             }
             m_result_stack.shrink(sz-3);
             if (sign)
@@ -343,10 +427,15 @@ struct goal2sat::imp {
             sat::bool_var k = m_solver.mk_var();
             sat::literal  l(k, false);
             m_cache.insert(t, l);
-            mk_clause(~l, l1, ~l2);
-            mk_clause(~l, ~l1, l2);
-            mk_clause(l,  l1, l2);
-            mk_clause(l, ~l1, ~l2);
+            unsigned pol = get_pol(t);
+            if (pol & POL_POS) {
+                mk_clause(~l, l1, ~l2);
+                mk_clause(~l, ~l1, l2);
+            }
+            if (pol & POL_NEG) {
+                mk_clause(l,  l1, l2);
+                mk_clause(l, ~l1, ~l2);
+            }
             m_result_stack.shrink(sz-2);
             if (sign)
                 l.neg();
@@ -449,6 +538,22 @@ struct goal2sat::imp {
         expr_ref f(m), d_new(m);
         ptr_vector<expr> deps;
         expr_ref_vector  fmls(m);
+        if (m_cnf_polarity) {
+            m_pol.reset();
+            for (unsigned idx = 0; idx < size; idx++) {
+                add_pol(g.form(idx), POL_POS);
+                if (g.dep(idx)) {
+                    // dependencies are defined by an equivalence in insert_dep.
+                    deps.reset();
+                    m.linearize(g.dep(idx), deps);
+                    for (expr * d : deps) {
+                        m.is_not(d, d);
+                        add_pol(d, POL_BOTH);
+                    }
+                }
+            }
+            propagate_pol();
+        }
         for (unsigned idx = 0; idx < size; idx++) {
             f = g.form(idx);
             // Add assumptions.
@@ -487,6 +592,12 @@ struct goal2sat::imp {
     void operator()(unsigned sz, expr * const * fs) {
         m_interface_vars.reset();
         collect_boolean_interface(m, sz, fs, m_interface_vars);
+        if (m_cnf_polarity) {
+            m_pol.reset();
+            for (unsigned i = 0; i < sz; i++)
+                add_pol(fs[i], POL_POS);
+            propagate_pol();
+        }
         
         for (unsigned i = 0; i < sz; i++)
             process(fs[i]);
@@ -531,6 +642,7 @@ goal2sat::goal2sat():m_imp(nullptr), m_interpreted_atoms(nullptr) {
 void goal2sat::collect_param_descrs(param_descrs & r) {
     insert_max_memory(r);
     r.insert("ite_extra", CPK_BOOL, "(default: true) add redundant clauses (that improve unit propagation) when encoding if-then-else formulas");
+    r.insert("cnf_polarity", CPK_BOOL, "(default: true) use the polarity of sub-formulas and only encode the needed direction of their definitions (Plaisted-Greenbaum encoding)");
 }
 
 struct goal2sat::scoped_set_imp {
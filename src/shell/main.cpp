@@ -38,7 +38,7 @@ Revision History:
 #include "util/file_path.h"
 #include "shell/lp_frontend.h"
 
-typedef enum { IN_UNSPECIFIED, IN_SMTLIB_2, IN_DATALOG, IN_DIMACS, IN_WCNF, IN_OPB, IN_Z3_LOG, IN_MPS } input_kind;
+typedef enum { IN_UNSPECIFIED, IN_SMTLIB_2, IN_DATALOG, IN_DIMACS, IN_WCNF, IN_OPB, IN_Z3_LOG, IN_MPS, IN_BINARY } input_kind;
 
 std::string         g_aux_input_file;
 char const *        g_input_file          = nullptr;
@@ -76,6 +76,7 @@ void display_usage() {
     std::cout << "  -dl         use parser for Datalog input format.\n";
     std::cout << "  -dimacs     use parser for DIMACS input format.\n";
     std::cout << "  -log        use parser for Z3 log input format.\n";
+    std::cout << "  -binary     read formulas in the binary format of Z3_write_binary_file and check them.\n";
     std::cout << "  -in         read formula from standard input.\n";
     std::cout << "\nMiscellaneous:\n";
     std::cout << "  -h, -?      prints this message.\n";
@@ -191,6 +192,9 @@ void parse_cmd_line_args(int argc, char ** argv) {
             else if (strcmp(opt_name, "log") == 0) {
                 g_input_kind = IN_Z3_LOG;
             }
+            else if (strcmp(opt_name, "binary") == 0) {
+                g_input_kind = IN_BINARY;
+            }
             else if (strcmp(opt_name, "st") == 0) {
                 g_display_statistics = true; 
             }
@@ -325,6 +329,9 @@ int STD_CALL main(int argc, char ** argv) {
                 else if (strcmp(ext, "smt2") == 0) {
                     g_input_kind = IN_SMTLIB_2;
                 }
+                else if (strcmp(ext, "z3b") == 0) {
+                    g_input_kind = IN_BINARY;
+                }
                 else if (strcmp(ext, "mps") == 0 || strcmp(ext, "sif") == 0 ||
                          strcmp(ext, "MPS") == 0 || strcmp(ext, "SIF") == 0) {
                     g_input_kind = IN_MPS;
@@ -354,6 +361,10 @@ int STD_CALL main(int argc, char ** argv) {
         case IN_MPS:
             return_value = read_mps_file(g_input_file);
             break;
+        case IN_BINARY:
+            memory::exit_when_out_of_memory(true, "(error \"out of memory\")");
+            return_value = read_binary_file(g_input_file);
+            break;
         default:
             UNREACHABLE();
         }
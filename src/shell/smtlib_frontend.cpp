@@ -22,6 +22,7 @@ Revision History:
 #include<time.h>
 #include<signal.h>
 #include "util/timeout.h"
+#include "ast/ast_binary.h"
 #include "parsers/smt2/smt2parser.h"
 #include "muz/fp/dl_cmds.h"
 #include "cmd_context/extra_cmds/dbg_cmds.h"
@@ -107,3 +108,44 @@ unsigned read_smtlib2_commands(char const * file_name) {
     return result ? 0 : 1;
 }
 
+
+unsigned read_binary_file(char const * file_name) {
+    g_start_time = clock();
+    register_on_timeout_proc(on_timeout);
+    signal(SIGINT, on_ctrl_c);
+    cmd_context ctx;
+
+    ctx.set_solver_factory(mk_smt_strategic_solver_factory());
+    g_cmd_context = &ctx;
+
+    expr_ref_vector fmls(ctx.m());
+    try {
+        if (file_name) {
+            std::ifstream in(file_name, std::ios::in | std::ios::binary);
+            if (in.bad() || in.fail()) {
+                std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
+                exit(ERR_OPEN_FILE);
+            }
+            ast_binary_read(in, ctx.m(), fmls);
+        }
+        else {
+            ast_binary_read(std::cin, ctx.m(), fmls);
+        }
+        for (expr * f : fmls) {
+            ctx.assert_expr(f);
+        }
+        ctx.check_sat(0, nullptr);
+    }
+    catch (z3_exception & ex) {
+        std::cout << "(error \"" << ex.msg() << "\")" << std::endl;
+        g_cmd_context = nullptr;
+        return 1;
+    }
+
+    #pragma omp critical (g_display_stats)
+    {
+        display_statistics();
+        g_cmd_context = nullptr;
+    }
+    return 0;
+}
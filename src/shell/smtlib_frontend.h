@@ -21,6 +21,7 @@ Revision History:
 
 unsigned read_smtlib_file(char const * benchmark_file);
 unsigned read_smtlib2_commands(char const * command_file);
+unsigned read_binary_file(char const * file_name);
 
 #endif /* SMTLIB_FRONTEND_H_ */
 
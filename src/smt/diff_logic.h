@@ -217,6 +217,9 @@ class dl_graph {
     // activity vector for edges.
     svector<unsigned>       m_activity;
 
+    // position of a var in the negative cycle traversed by traverse_neg_cycle2, -1 if absent.
+    int_vector              m_cycle_pos;      // per var
+
 
     bool check_invariant() const {
 #ifdef Z3DEBUG
@@ -584,6 +587,7 @@ public:
         edge_id e_id    = last_id;
         numeral gamma = m_gamma[last_e.get_source()];
         SASSERT(check_gamma(last_id));
+        m_cycle_pos.resize(m_assignment.size(), -1);
 
         do {
             SASSERT(gamma.is_neg());
@@ -604,40 +608,52 @@ public:
                 if (e_id2 == e_id || !e2.is_enabled()) {
                     continue;
                 }
-                for (unsigned j = 0; j < nodes.size(); ++j) {
-                    if (nodes[j] != src2) {
-                        continue;
-                    }
-                    numeral const& weight = e2.get_weight();
-                    numeral delta = weight - potential + potentials[j];
-                    if (delta.is_nonneg() && (gamma + delta).is_neg()) {
-                        TRACE("diff_logic_traverse", tout << "Reducing path by ";
-                              display_edge(tout, e2);
-                              tout << "gamma: " << gamma << " weight: " << weight << "\n";
-                              tout << "enabled: " << e2.is_enabled() << "\n";
-                              tout << "delta: " << delta << "\n";
-                              tout << "literals saved: " << (nodes.size() - j - 1) << "\n";
-                              );
-                        gamma += delta;
-                        nodes.shrink(j + 1);
-                        potentials.shrink(j + 1);
-                        edges.shrink(j + 1);
-                        edges.push_back(e_id2);           
-                        potential = potentials[j] + weight;
-                        break;
-                    }
-                    else {
-                        TRACE("diff_logic_traverse", display_edge(tout << "skipping: ", e2););
+                // the cycle positions replace a linear scan over nodes, 
+                // which made the traversal quadratic in the cycle length.
+                int j = m_cycle_pos[src2];
+                if (j < 0) {
+                    continue;
+                }
+                numeral const& weight = e2.get_weight();
+                numeral delta = weight - potential + potentials[j];
+                if (delta.is_nonneg() && (gamma + delta).is_neg()) {
+                    TRACE("diff_logic_traverse", tout << "Reducing path by ";
+                          display_edge(tout, e2);
+                          tout << "gamma: " << gamma << " weight: " << weight << "\n";
+                          tout << "enabled: " << e2.is_enabled() << "\n";
+                          tout << "delta: " << delta << "\n";
+                          tout << "literals saved: " << (nodes.size() - j - 1) << "\n";
+                          );
+                    gamma += delta;
+                    for (unsigned k = j + 1; k < nodes.size(); ++k) {
+                        if (m_cycle_pos[nodes[k]] > j) {
+                            m_cycle_pos[nodes[k]] = -1;
+                        }
                     }
+                    nodes.shrink(j + 1);
+                    potentials.shrink(j + 1);
+                    edges.shrink(j + 1);
+                    edges.push_back(e_id2);           
+                    potential = potentials[j] + weight;
+                }
+                else {
+                    TRACE("diff_logic_traverse", display_edge(tout << "skipping: ", e2););
                 }
             }
             potentials.push_back(potential);
+            if (m_cycle_pos[src] < 0) {
+                m_cycle_pos[src] = nodes.size();
+            }
             nodes.push_back(src);
             e_id = m_parent[src];
                   
             SASSERT(check_path(potentials, nodes, edges));
         }
         while (e_id != last_id);
+
+        for (dl_var v : nodes) {
+            m_cycle_pos[v] = -1;
+        }
         
         TRACE("diff_logic_traverse", {   
                 tout << "Num conflicts: " << num_conflicts << "\n";
@@ -1078,6 +1094,7 @@ public:
         m_heap              .reset();
         m_enabled_edges     .reset();
         m_activity          .reset();
+        m_cycle_pos         .reset();
     }
 
     // Compute strongly connected components connected by (normalized) zero edges.
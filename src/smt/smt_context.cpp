@@ -3251,6 +3251,7 @@ namespace smt {
        and before internalizing any formulas.
     */
     lbool context::setup_and_check(bool reset_cancel) {
+        scoped_memory_tag _mt("smt");
         if (!check_preamble(reset_cancel))
             return l_undef;
         SASSERT(m_scope_lvl == 0);
@@ -3328,6 +3329,7 @@ namespace smt {
     }
 
     lbool context::check(unsigned ext_num_assumptions, expr * const * ext_assumptions, bool reset_cancel, bool already_did_theory_assumptions) {
+        scoped_memory_tag _mt("smt");
         m_stats.m_num_checks++;
         TRACE("check_bug", tout << "STARTING check(num_assumptions, assumptions)\n";
               tout << "inconsistent: " << inconsistent() << ", m_unsat_core.empty(): " << m_unsat_core.empty() << "\n";
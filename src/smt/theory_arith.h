@@ -47,6 +47,7 @@ namespace smt {
         unsigned m_max_min; 
         unsigned m_gb_simplify, m_gb_superpose, m_gb_compute_basis, m_gb_num_processed;
         unsigned m_nl_branching, m_nl_linear, m_nl_bounds, m_nl_cross_nested;
+        unsigned m_gomory_cuts_repeated, m_gomory_cut_lemmas;
 
         void reset() { memset(this, 0, sizeof(theory_arith_stats)); }
         theory_arith_stats() { reset(); }
@@ -467,6 +468,11 @@ namespace smt {
         unsigned                m_num_conflicts;
 
         unsigned                m_branch_cut_counter;
+        // Gomory cuts generated so far, keyed by the normalized cut.
+        // A cut that is generated again was lost during backtracking,
+        // it is then added as a lemma that survives backtracking.
+        obj_hashtable<expr>     m_gomory_cut_pool;
+        expr_ref_vector         m_gomory_cut_pool_exprs;
         bool                    m_eager_gcd; // true if gcd should be applied at every add_row
         unsigned                m_final_check_idx;
 
@@ -834,6 +840,7 @@ namespace smt {
         bool constrain_free_vars(row const & r);
         bool is_gomory_cut_target(row const & r);
         bool mk_gomory_cut(row const & r);
+        bool is_repeated_gomory_cut(expr * bound);
         bool gcd_test(row const & r);
         bool ext_gcd_test(row const & r, numeral const & least_coeff, numeral const & lcm_den, numeral const & consts);
         bool gcd_test();
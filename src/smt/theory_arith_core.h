@@ -1592,6 +1592,8 @@ namespace smt {
         m_to_check               .reset();
         m_in_to_check            .reset();
         m_num_conflicts          = 0;
+        m_gomory_cut_pool        .reset();
+        m_gomory_cut_pool_exprs  .reset();
         m_bound_trail            .reset();
         m_unassigned_atoms_trail .reset();
         m_scopes                 .reset();
@@ -1683,6 +1685,7 @@ namespace smt {
         m_random(params.m_arith_random_seed),
         m_num_conflicts(0),
         m_branch_cut_counter(0),
+        m_gomory_cut_pool_exprs(m),
         m_eager_gcd(m_params.m_arith_eager_gcd),
         m_final_check_idx(0),
         m_antecedents_index(0),
@@ -646,6 +646,21 @@ namespace smt {
         l = ctx.get_literal(bound);
         ctx.mark_as_relevant(l);
         dump_lemmas(l, ante);
+        if (is_repeated_gomory_cut(bound) && ante.lits().size() < small_lemma_size() && ante.eqs().empty()) {
+            m_stats.m_gomory_cut_lemmas++;
+            literal_vector & lits = m_tmp_literal_vector2;
+            lits.reset();
+            lits.push_back(l);
+            for (literal a : ante.lits()) 
+                lits.push_back(~a);
+            justification * js = nullptr;
+            if (proofs_enabled()) {
+                js = alloc(theory_lemma_justification, get_id(), ctx, lits.size(), lits.c_ptr(),
+                           ante.num_params(), ante.params("gomory-cut"));
+            }
+            ctx.mk_clause(lits.size(), lits.c_ptr(), js, CLS_AUX_LEMMA, nullptr);
+            return true;
+        }
         ctx.assign(l, ctx.mk_justification(
                        gomory_cut_justification(
                            get_id(), ctx.get_region(), 
@@ -653,6 +668,28 @@ namespace smt {
                            ante.eqs().size(), ante.eqs().c_ptr(), ante, l)));
         return true;
     }
+
+    /**
+       \brief Record the cut in the pool of Gomory cuts.
+       Return true if the same (normalized) cut was generated before.
+
+       The pool is flushed when it grows past a fixed size, cuts that keep
+       reappearing are re-inserted after the flush.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::is_repeated_gomory_cut(expr * bound) {
+        if (m_gomory_cut_pool.contains(bound)) {
+            m_stats.m_gomory_cuts_repeated++;
+            return true;
+        }
+        if (m_gomory_cut_pool_exprs.size() >= 10000) {
+            m_gomory_cut_pool.reset();
+            m_gomory_cut_pool_exprs.reset();
+        }
+        m_gomory_cut_pool.insert(bound);
+        m_gomory_cut_pool_exprs.push_back(bound);
+        return false;
+    }
     
     /**
        \brief Return false if the row failed the GCD test, that is, a conflict was detected.
@@ -38,6 +38,8 @@ namespace smt {
         st.update("arith gcd tests", m_stats.m_gcd_tests);
         st.update("arith ineq splits", m_stats.m_branches);
         st.update("arith gomory cuts", m_stats.m_gomory_cuts);
+        st.update("arith gomory cuts repeated", m_stats.m_gomory_cuts_repeated);
+        st.update("arith gomory cut lemmas", m_stats.m_gomory_cut_lemmas);
         st.update("arith max-min", m_stats.m_max_min);
         st.update("arith grobner", m_stats.m_gb_compute_basis);
         st.update("arith pseudo nonlinear", m_stats.m_nl_linear);
@@ -20,6 +20,7 @@ Notes:
 #include "tactic/goal.h"
 #include "ast/ast_smt2_pp.h"
 #include "util/cooperate.h"
+#include "sat/sat_solver.h"
 
 #define USE_TWO_LEVEL_RULES
 #define FIRST_NODE_ID (UINT_MAX/2)
@@ -1298,6 +1299,282 @@ struct aig_manager::imp {
         }
     };
 
+    /**
+       \brief Functional reduction (FRAIG) of an AIG.
+
+       The nodes reachable from the root are simulated on random input patterns,
+       64 patterns per machine word. Nodes with the same signature, modulo
+       complementation, are candidate equivalences. The AIG is then rebuilt bottom up,
+       and every rebuilt node is checked against the earlier members of its candidate
+       class with an incremental SAT solver. A node that is proved equivalent (or
+       complementary) to an earlier node is replaced by it. The constant node true
+       is simulated as all ones, so constant nodes are detected in the same way.
+
+       The SAT queries share a conflict budget. Once it is exhausted, the remaining
+       nodes are only rebuilt (i.e., structurally hashed and locally simplified by mk_node).
+    */
+    struct fraig_proc {
+        static const unsigned num_words = 4;  // 256 patterns
+        static const unsigned max_tries = 4;  // class members tried per node
+
+        imp &                  m;
+        unsigned               m_max_conflicts;
+        scoped_ptr<sat::solver> m_solver;     // created by the first SAT query
+        random_gen             m_rand;
+        ptr_vector<aig>        m_nodes;       // reachable nodes in topological order
+        u_map<unsigned>        m_id2idx;      // node id -> position in m_nodes
+        svector<uint64>        m_sims;        // signatures, num_words per node
+        svector<bool>          m_phase;       // true if the signature was complemented
+        u_map<unsigned>        m_hash2class;  // hash of normalized signature -> class
+        vector<unsigned_vector> m_classes;    // members of every class that were not merged
+        svector<aig_lit>       m_new;         // rebuilt node of every node
+        u_map<sat::bool_var>   m_id2var;      // rebuilt node id -> sat variable
+        ptr_vector<aig>        m_encoded;     // nodes with a sat variable, kept alive
+        bool                   m_budget_exhausted;
+        unsigned               m_num_merged;
+
+        fraig_proc(imp & _m, unsigned max_conflicts):
+            m(_m),
+            m_max_conflicts(max_conflicts),
+            m_budget_exhausted(false),
+            m_num_merged(0) {
+        }
+
+        ~fraig_proc() {
+            for (aig_lit const & l : m_new)
+                if (!l.is_null())
+                    m.dec_ref(l);
+            m.dec_array_ref(m_encoded.size(), m_encoded.c_ptr());
+        }
+
+        uint64 * sim(unsigned idx) { return m_sims.c_ptr() + idx * num_words; }
+
+        uint64 random_word() {
+            uint64 r = 0;
+            for (unsigned i = 0; i < 5; i++)
+                r = (r << 15) ^ static_cast<uint64>(m_rand());
+            return r;
+        }
+
+        void collect(aig * root) {
+            ptr_vector<aig> todo;
+            // the constant comes first, so that it heads the class of constant nodes.
+            m.m_true.ptr()->m_mark = true;
+            m_nodes.push_back(m.m_true.ptr());
+            todo.push_back(root);
+            while (!todo.empty()) {
+                aig * n = todo.back();
+                if (n->m_mark) {
+                    todo.pop_back();
+                    continue;
+                }
+                bool visited = true;
+                if (!is_var(n)) {
+                    for (unsigned i = 0; i < 2; i++) {
+                        aig * c = n->m_children[i].ptr();
+                        if (!c->m_mark) {
+                            todo.push_back(c);
+                            visited = false;
+                        }
+                    }
+                }
+                if (visited) {
+                    n->m_mark = true;
+                    m_nodes.push_back(n);
+                    todo.pop_back();
+                }
+            }
+            unmark(m_nodes.size(), m_nodes.c_ptr());
+            for (unsigned i = 0; i < m_nodes.size(); i++)
+                m_id2idx.insert(m_nodes[i]->m_id, i);
+        }
+
+        void child_sim(aig_lit const & c, uint64 * r) {
+            uint64 * s = sim(m_id2idx[id(c)]);
+            uint64 mask = c.is_inverted() ? ~static_cast<uint64>(0) : 0;
+            for (unsigned w = 0; w < num_words; w++)
+                r[w] = s[w] ^ mask;
+        }
+
+        void simulate() {
+            m_sims.resize(m_nodes.size() * num_words, 0);
+            uint64 l[num_words], r[num_words];
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                aig * n  = m_nodes[i];
+                uint64 * s = sim(i);
+                if (n->m_id == 0) {
+                    for (unsigned w = 0; w < num_words; w++)
+                        s[w] = ~static_cast<uint64>(0);
+                }
+                else if (is_var(n)) {
+                    for (unsigned w = 0; w < num_words; w++)
+                        s[w] = random_word();
+                }
+                else {
+                    child_sim(left(n), l);
+                    child_sim(right(n), r);
+                    for (unsigned w = 0; w < num_words; w++)
+                        s[w] = l[w] & r[w];
+                }
+            }
+        }
+
+        // Normalize the signature of node idx so that its first bit is 0,
+        // and return the class of the node.
+        unsigned get_class(unsigned idx) {
+            uint64 * s = sim(idx);
+            bool phase = (s[0] & 1) != 0;
+            m_phase.push_back(phase);
+            if (phase)
+                for (unsigned w = 0; w < num_words; w++)
+                    s[w] = ~s[w];
+            unsigned h = string_hash(reinterpret_cast<char const *>(s), num_words * sizeof(uint64), 17);
+            unsigned c;
+            if (m_hash2class.find(h, c)) {
+                uint64 * s2 = sim(m_classes[c][0]);
+                bool eq = true;
+                for (unsigned w = 0; eq && w < num_words; w++)
+                    eq = s[w] == s2[w];
+                if (eq)
+                    return c;
+                // hash collision, the node gets a class of its own.
+            }
+            else {
+                m_hash2class.insert(h, m_classes.size());
+            }
+            m_classes.push_back(unsigned_vector());
+            return m_classes.size() - 1;
+        }
+
+        sat::literal to_sat(aig_lit const & l) {
+            ptr_vector<aig> todo;
+            todo.push_back(l.ptr());
+            while (!todo.empty()) {
+                aig * n = todo.back();
+                if (m_id2var.contains(n->m_id)) {
+                    todo.pop_back();
+                    continue;
+                }
+                sat::literal a, b;
+                if (!is_var(n)) {
+                    bool visited = true;
+                    for (unsigned i = 0; i < 2; i++) {
+                        if (!m_id2var.contains(id(n->m_children[i]))) {
+                            todo.push_back(n->m_children[i].ptr());
+                            visited = false;
+                        }
+                    }
+                    if (!visited)
+                        continue;
+                    a = to_sat_core(left(n));
+                    b = to_sat_core(right(n));
+                }
+                todo.pop_back();
+                sat::bool_var v = m_solver->mk_var(true, true);
+                sat::literal lv(v, false);
+                if (n->m_id == 0) {
+                    m_solver->mk_clause(1, &lv);
+                }
+                else if (!is_var(n)) {
+                    m_solver->mk_clause(~lv, a);
+                    m_solver->mk_clause(~lv, b);
+                    m_solver->mk_clause(lv, ~a, ~b);
+                }
+                m_id2var.insert(n->m_id, v);
+                m.inc_ref(n);
+                m_encoded.push_back(n);
+            }
+            return to_sat_core(l);
+        }
+
+        sat::literal to_sat_core(aig_lit const & l) {
+            return sat::literal(m_id2var[id(l)], l.is_inverted());
+        }
+
+        lbool check(sat::literal l1, sat::literal l2) {
+            sat::literal lits[2] = { l1, l2 };
+            return m_solver->check(2, lits);
+        }
+
+        // Return true if l1 and l2 are equivalent.
+        bool prove(aig_lit const & l1, aig_lit const & l2) {
+            if (m_budget_exhausted)
+                return false;
+            if (!m_solver) {
+                params_ref p;
+                p.set_uint("max_conflicts", m_max_conflicts);
+                m_solver = alloc(sat::solver, p, m.m().limit(), nullptr);
+            }
+            sat::literal a = to_sat(l1);
+            sat::literal b = to_sat(l2);
+            lbool r = check(a, ~b);
+            if (r == l_false)
+                r = check(~a, b);
+            if (r == l_undef) {
+                m_budget_exhausted = true;
+                return false;
+            }
+            if (r == l_true)
+                return false;
+            m_solver->mk_clause(~a, b);
+            m_solver->mk_clause(a, ~b);
+            return true;
+        }
+
+        aig_lit new_child(aig_lit const & c) {
+            aig_lit r = m_new[m_id2idx[id(c)]];
+            if (c.is_inverted())
+                r.invert();
+            return r;
+        }
+
+        void rebuild() {
+            m_new.resize(m_nodes.size(), aig_lit::null);
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                m.checkpoint();
+                aig * n = m_nodes[i];
+                unsigned c = get_class(i);
+                aig_lit r;
+                if (is_var(n))
+                    r = aig_lit(n);
+                else
+                    r = m.mk_and(new_child(left(n)), new_child(right(n)));
+                m.inc_ref(r);
+                bool merged = false;
+                if (!is_var(n)) {
+                    unsigned_vector const & members = m_classes[c];
+                    for (unsigned k = 0; k < members.size() && k < max_tries; k++) {
+                        unsigned j = members[k];
+                        aig_lit t = m_new[j];
+                        if (m_phase[i] != m_phase[j])
+                            t.invert();
+                        if (t != r && !prove(r, t))
+                            continue;
+                        m.inc_ref(t);
+                        m.dec_ref(r);
+                        r = t;
+                        merged = true;
+                        m_num_merged++;
+                        break;
+                    }
+                }
+                m_new[i] = r;
+                if (!merged)
+                    m_classes[c].push_back(i);
+            }
+        }
+
+        aig_lit operator()(aig_lit p) {
+            collect(p.ptr());
+            simulate();
+            rebuild();
+            aig_lit r = new_child(p);
+            m.inc_ref(r);
+            TRACE("aig_fraig", tout << "merged: " << m_num_merged << "\n"; m.display(tout, r););
+            return r;
+        }
+    };
+
 public:
     imp(ast_manager & m, unsigned long long max_memory, bool default_gate_encoding):
         m_var_id_gen(0),
@@ -1545,6 +1822,16 @@ public:
         return p(l);
     }
 
+    aig_lit fraig(aig_lit l, unsigned max_conflicts) {
+        aig_lit r;
+        {
+            fraig_proc p(*this, max_conflicts);
+            r = p(l);
+        }
+        dec_ref_result(r);
+        return r;
+    }
+
     void display_ref(std::ostream & out, aig * r) const {
         if (is_var(r)) 
             out << "#" << r->m_id;
@@ -1726,6 +2013,10 @@ void aig_manager::max_sharing(aig_ref & r) {
     r = aig_ref(*this, m_imp->max_sharing(aig_lit(r)));
 }
 
+void aig_manager::fraig(aig_ref & r, unsigned max_conflicts) {
+    r = aig_ref(*this, m_imp->fraig(aig_lit(r), max_conflicts));
+}
+
 void aig_manager::to_formula(aig_ref const & r, goal & g) {
     SASSERT(!g.proofs_enabled());
     SASSERT(!g.unsat_core_enabled());
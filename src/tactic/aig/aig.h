@@ -68,6 +68,9 @@ public:
     aig_ref mk_iff(aig_ref const & r1, aig_ref const & r2);
     aig_ref mk_ite(aig_ref const & r1, aig_ref const & r2, aig_ref const & r3);
     void max_sharing(aig_ref & r);
+    // Merge functionally equivalent nodes of r, see fraig_proc in aig.cpp.
+    // max_conflicts bounds the total effort of the SAT queries.
+    void fraig(aig_ref & r, unsigned max_conflicts);
     void to_formula(aig_ref const & r, expr_ref & result);
     void to_formula(aig_ref const & r, goal & result);
     void display(std::ostream & out, aig_ref const & r) const;
@@ -203,6 +203,7 @@ void dom_simplify_tactic::cleanup() {
     m_args.reset();
     m_result.reset();
     m_dominators.reset();
+    m_subexpr_cache.reset();
 }
 
 expr_ref dom_simplify_tactic::simplify_ite(app * ite) {
@@ -301,7 +302,6 @@ expr_ref dom_simplify_tactic::simplify_rec(expr * e0) {
     cache(e0, r);
     TRACE("simplify", tout << "depth: " << m_depth << " " << mk_pp(e0, m) << " -> " << r << "\n";);
     --m_depth;
-    m_subexpr_cache.reset();
     return r;
 }
 
@@ -356,9 +356,15 @@ bool dom_simplify_tactic::init(goal& g) {
     unsigned sz = g.size();
     for (unsigned i = 0; i < sz; ++i) args.push_back(g.form(i));
     expr_ref fml = mk_and(args);
+    reset_results();
+    // is_subexpr only depends on the dominator tree, so its cache is valid until the tree changes.
+    m_subexpr_cache.reset();
+    return m_dominators.compile(fml);
+}
+
+void dom_simplify_tactic::reset_results() {
     m_result.reset();
     m_trail.reset();
-    return m_dominators.compile(fml);
 }
 
 void dom_simplify_tactic::simplify_goal(goal& g) {
@@ -389,8 +395,13 @@ void dom_simplify_tactic::simplify_goal(goal& g) {
         pop(scope_level());
         
         // go backwards
+        // the dominator tree only has to be rebuilt if the forward pass changed the goal,
+        // the cached results are specific to the direction of the pass.
         m_forward = false;
-        if (!init(g)) return;
+        if (!change)
+            reset_results();
+        else if (!init(g)) 
+            return;
         sz = g.size();
         for (unsigned i = sz; !g.inconsistent() && i > 0; ) {
             --i;
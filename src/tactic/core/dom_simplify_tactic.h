@@ -122,6 +122,7 @@ class dom_simplify_tactic : public tactic {
     bool assert_expr(expr* f, bool sign) { return m_simplifier->assert_expr(f, sign); }
 
     bool init(goal& g);
+    void reset_results();
 
 public:
     dom_simplify_tactic(ast_manager & m, dom_simplifier* s, params_ref const & p = params_ref()):
@@ -23,6 +23,7 @@ Revision History:
 #include "ast/ast_smt2_pp.h"
 #include "ast/expr_substitution.h"
 #include "tactic/goal_shared_occs.h"
+#include "tactic/goal_util.h"
 
 class propagate_values_tactic : public tactic {
     struct     imp {
@@ -31,6 +32,13 @@ class propagate_values_tactic : public tactic {
         scoped_ptr<expr_substitution> m_subst;
         goal *                        m_goal;
         goal_shared_occs              m_occs;
+        // Formulas in different components share no uninterpreted symbols, so a substitution
+        // entry can only simplify the formulas of the components of the symbols it contains.
+        // Formulas of components without entries are not rewritten.
+        unsigned                      m_num_comps; // 0 if the goal is not partitioned
+        unsigned_vector               m_comp;      // component of each formula
+        obj_map<func_decl, unsigned>  m_decl2comp;
+        svector<bool>                 m_comp_subst; // true if the substitution has entries for the component
         unsigned                      m_idx;
         unsigned                      m_max_rounds;
         bool                          m_modified;
@@ -39,7 +47,8 @@ class propagate_values_tactic : public tactic {
             m(m),
             m_r(m, p),
             m_goal(nullptr),
-            m_occs(m, true /* track atoms */) {
+            m_occs(m, true /* track atoms */),
+            m_num_comps(0) {
             updt_params_core(p);
         }
 
@@ -58,6 +67,62 @@ class propagate_values_tactic : public tactic {
         bool is_shared(expr * t) {
             return m_occs.is_shared(t);
         }
+
+        void init_components() {
+            // small goals are not worth partitioning.
+            m_num_comps = m_goal->size() < 64 ? 0 : get_goal_components(*m_goal, m_comp, &m_decl2comp);
+            if (m_num_comps == 1)
+                m_num_comps = 0;
+            m_comp_subst.reset();
+            m_comp_subst.resize(m_num_comps, false);
+        }
+
+        // start a new pass: the substitution is about to be reset.
+        void init_occs() {
+            m_occs(*m_goal);
+            for (unsigned i = 0; i < m_num_comps; i++)
+                m_comp_subst[i] = false;
+        }
+
+        bool use_subst() const {
+            return !m_subst->empty() && (m_num_comps == 0 || m_comp_subst[m_comp[m_idx]]);
+        }
+
+        void mark_components(expr * s) {
+            m_comp_subst[m_comp[m_idx]] = true;
+            // the key may also occur in the formulas of the components of its symbols.
+            bool has_symbol = false;
+            expr_fast_mark1 visited;
+            ptr_buffer<expr> todo;
+            todo.push_back(s);
+            while (!todo.empty()) {
+                expr * e = todo.back();
+                todo.pop_back();
+                if (!is_app(e) || visited.is_marked(e))
+                    continue;
+                visited.mark(e);
+                app * a = to_app(e);
+                if (a->get_family_id() == null_family_id) {
+                    unsigned c;
+                    if (m_decl2comp.find(a->get_decl(), c)) {
+                        m_comp_subst[c] = true;
+                        has_symbol = true;
+                    }
+                }
+                for (expr * arg : *a)
+                    todo.push_back(arg);
+            }
+            if (!has_symbol) {
+                for (unsigned i = 0; i < m_num_comps; i++)
+                    m_comp_subst[i] = true;
+            }
+        }
+
+        void insert_subst(expr * s, expr * def, proof * def_pr, expr_dependency * def_dep) {
+            m_subst->insert(s, def, def_pr, def_dep);
+            if (m_num_comps > 0)
+                mark_components(s);
+        }
         
         bool is_shared_neg(expr * t, expr * & atom) {            
             if (!m.is_not(t, atom))
@@ -101,16 +166,16 @@ class propagate_values_tactic : public tactic {
             m_goal->update(m_idx, new_curr, new_pr, new_d);
         
             if (is_shared(new_curr)) {
-                m_subst->insert(new_curr, m.mk_true(), m.mk_iff_true(new_pr), new_d);
+                insert_subst(new_curr, m.mk_true(), m.mk_iff_true(new_pr), new_d);
             }
             expr * atom;
             if (is_shared_neg(new_curr, atom)) {
-                m_subst->insert(atom, m.mk_false(), m.mk_iff_false(new_pr), new_d);
+                insert_subst(atom, m.mk_false(), m.mk_iff_false(new_pr), new_d);
             }
             expr * lhs, * value;
             if (is_shared_eq(new_curr, lhs, value)) {
                 TRACE("shallow_context_simplifier_bug", tout << "found eq:\n" << mk_ismt2_pp(new_curr, m) << "\n";);
-                m_subst->insert(lhs, value, new_pr, new_d);
+                insert_subst(lhs, value, new_pr, new_d);
             }
         }
         
@@ -119,7 +184,7 @@ class propagate_values_tactic : public tactic {
             expr_ref   new_curr(m);
             proof_ref  new_pr(m);
             
-            if (!m_subst->empty()) {
+            if (use_subst()) {
                 m_r(curr, new_curr, new_pr);
             }
             else {
@@ -162,7 +227,8 @@ class propagate_values_tactic : public tactic {
 
             m_subst = alloc(expr_substitution, m, g->unsat_core_enabled(), g->proofs_enabled());
             m_r.set_substitution(m_subst.get());
-            m_occs(*m_goal);
+            init_components();
+            init_occs();
 
             while (true) {
                 TRACE("propagate_values", tout << "while(true) loop\n"; m_goal->display_with_dependencies(tout););
@@ -174,7 +240,7 @@ class propagate_values_tactic : public tactic {
                     }
                     if (m_subst->empty() && !m_modified)
                         goto end;
-                    m_occs(*m_goal);
+                    init_occs();
                     m_idx        = m_goal->size();
                     forward      = false;
                     m_subst->reset();
@@ -192,7 +258,7 @@ class propagate_values_tactic : public tactic {
                     m_subst->reset();
                     m_r.set_substitution(m_subst.get()); // reset, but keep substitution
                     m_modified   = false;
-                    m_occs(*m_goal);
+                    init_occs();
                     m_idx        = 0;
                     size         = m_goal->size();
                     forward      = true;
@@ -110,10 +110,17 @@ void simplify_tactic::operator()(goal_ref const & in,
 
 
 void simplify_tactic::cleanup() {
-    ast_manager & m = m_imp->m();
-    params_ref p = std::move(m_params);
-    m_imp->~imp();
-    new (m_imp) imp(m, p);
+    // th_rewriter::cleanup keeps the persistent cache of the rewriter (if enabled).
+    m_imp->m_r.cleanup();
+    m_imp->m_num_steps = 0;
+}
+
+void simplify_tactic::collect_statistics(statistics & st) const {
+    m_imp->m_r.collect_statistics(st);
+}
+
+void simplify_tactic::reset_statistics() {
+    m_imp->m_r.reset_statistics();
 }
 
 unsigned simplify_tactic::get_num_steps() const {
@@ -18,6 +18,7 @@ Revision History:
 --*/
 #include "tactic/goal_util.h"
 #include "tactic/goal.h"
+#include "util/union_find.h"
 
 struct has_term_ite_functor {
     struct found {};
@@ -31,3 +32,105 @@ struct has_term_ite_functor {
 bool has_term_ite(goal const & g) {
     return test<has_term_ite_functor>(g);
 }
+
+/**
+   \brief Return true if the interpretation of s is not fixed by the theories.
+   Formulas mentioning such a sort constrain its universe, e.g., a quantifier
+   (forall ((x U) (y U)) (= x y)) bounds the number of elements of U. Datatype
+   sorts are included, since their universe may depend on uninterpreted sorts.
+*/
+static bool is_free_sort(ast_manager & m, sort * s) {
+    return m.is_uninterp(s) || s->get_family_id() == m.mk_family_id("datatype");
+}
+
+unsigned get_goal_components(goal const & g, unsigned_vector & comp, obj_map<func_decl, unsigned> * decl2comp) {
+    unsigned sz = g.size();
+    basic_union_find uf;
+    for (unsigned i = 0; i < sz; i++)
+        uf.mk_var();
+    // decl2owner maps an uninterpreted symbol to the first formula containing it,
+    // owner[id] the expression with the given id to the first formula containing it.
+    // A shared subterm is only visited once, the formulas containing it are merged.
+    // Interpreted constants (numerals, true, false, ...) are skipped, as they do not
+    // relate formulas. sort2owner maps an uninterpreted sort to the first formula
+    // mentioning it, in a term, a bound variable, or as a parameter of another sort.
+    ast_manager & m = g.m();
+    obj_map<func_decl, unsigned> decl2owner;
+    obj_map<sort, unsigned> sort2owner;
+    unsigned_vector owner;
+    ptr_vector<expr> todo;
+    ptr_vector<sort> sorts;
+    auto add_sort = [&](unsigned i, sort * s) {
+        sorts.push_back(s);
+        while (!sorts.empty()) {
+            s = sorts.back();
+            sorts.pop_back();
+            if (is_free_sort(m, s)) {
+                unsigned j = 0;
+                if (sort2owner.find(s, j)) {
+                    uf.merge(i, j);
+                    continue;
+                }
+                sort2owner.insert(s, i);
+            }
+            for (unsigned k = 0; k < s->get_num_parameters(); ++k) {
+                parameter const & p = s->get_parameter(k);
+                if (p.is_ast() && is_sort(p.get_ast()))
+                    sorts.push_back(to_sort(p.get_ast()));
+            }
+        }
+    };
+    for (unsigned i = 0; i < sz; i++) {
+        todo.push_back(g.form(i));
+        while (!todo.empty()) {
+            expr * e = todo.back();
+            todo.pop_back();
+            if (is_app(e) && to_app(e)->get_num_args() == 0 && to_app(e)->get_family_id() != null_family_id)
+                continue;
+            unsigned id = e->get_id();
+            if (id >= owner.size())
+                owner.resize(id + 1, UINT_MAX);
+            if (owner[id] != UINT_MAX) {
+                uf.merge(i, owner[id]);
+                continue;
+            }
+            owner[id] = i;
+            add_sort(i, m.get_sort(e));
+            if (is_app(e)) {
+                app * a = to_app(e);
+                if (a->get_family_id() == null_family_id) {
+                    unsigned j = 0;
+                    if (decl2owner.find(a->get_decl(), j))
+                        uf.merge(i, j);
+                    else
+                        decl2owner.insert(a->get_decl(), i);
+                }
+                for (expr * arg : *a)
+                    todo.push_back(arg);
+            }
+            else if (is_quantifier(e)) {
+                quantifier * q = to_quantifier(e);
+                for (unsigned k = 0; k < q->get_num_decls(); ++k)
+                    add_sort(i, q->get_decl_sort(k));
+                todo.push_back(q->get_expr());
+            }
+        }
+    }
+    comp.reset();
+    comp.resize(sz, UINT_MAX);
+    unsigned_vector root2comp;
+    root2comp.resize(sz, UINT_MAX);
+    unsigned num_comps = 0;
+    for (unsigned i = 0; i < sz; i++) {
+        unsigned r = uf.find(i);
+        if (root2comp[r] == UINT_MAX)
+            root2comp[r] = num_comps++;
+        comp[i] = root2comp[r];
+    }
+    if (decl2comp) {
+        decl2comp->reset();
+        for (auto const & kv : decl2owner)
+            decl2comp->insert(kv.m_key, comp[kv.m_value]);
+    }
+    return num_comps;
+}
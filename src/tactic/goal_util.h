@@ -19,7 +19,25 @@ Revision History:
 #ifndef GOAL_UTIL_H_
 #define GOAL_UTIL_H_
 
+#include "util/vector.h"
+#include "util/obj_hashtable.h"
+
+class func_decl;
+
 class goal;
 bool has_term_ite(goal const & g);
 
+/**
+   \brief Partition the formulas of g into independent components.
+   Two formulas are in the same component if they (transitively) share an
+   uninterpreted function or constant symbol, a compound subterm, or an
+   uninterpreted or datatype sort (also as the sort of a bound variable).
+   Interpreted constants (numerals, true, false, ...) do not relate formulas.
+
+   Return the number of components, and store in comp[i] the component of g.form(i).
+   If decl2comp is not null, it is filled with the component of every uninterpreted
+   symbol occurring in g. Components are numbered in the order of their first formula.
+*/
+unsigned get_goal_components(goal const & g, unsigned_vector & comp, obj_map<func_decl, unsigned> * decl2comp = nullptr);
+
 #endif
@@ -83,7 +83,7 @@ private:
     ptr_vector<func_decl> m_constants;
     ptr_vector<func_decl> m_temp_constants;
     occ_type              m_constants_occ;
-    unsigned              m_last_pos;
+    expr *                m_last_unsat;
     unsigned              m_walksat;
     unsigned              m_ucb;
     double                m_ucb_constant;
@@ -94,8 +94,12 @@ private:
     double                m_scale_unsat;
     unsigned              m_paws_init;
     obj_map<expr, unsigned>    m_where_false;
-    expr**                    m_list_false;
+    ptr_vector<expr>      m_list_false;
     unsigned              m_track_unsat;
+    // constants occurring in unsat assertions, maintained for gsat when tracking unsat assertions.
+    obj_map<func_decl, unsigned> m_unsat_occs;   // number of unsat assertions a constant occurs in
+    obj_map<func_decl, unsigned> m_where_unsat;  // position of a constant in m_unsat_constants
+    ptr_vector<func_decl> m_unsat_constants;
     obj_map<expr, unsigned> m_weights;
     double                  m_top_sum;
     obj_hashtable<expr>   m_temp_seen;
@@ -109,7 +113,9 @@ public:
         m_random_bits_cnt(0),        
         m_zero(m_mpz_manager.mk_z(0)),
         m_one(m_mpz_manager.mk_z(1)),
-        m_two(m_mpz_manager.mk_z(2)) {
+        m_two(m_mpz_manager.mk_z(2)),
+        m_last_unsat(nullptr),
+        m_track_unsat(0) {
     }
             
     ~sls_tracker() {
@@ -128,9 +134,7 @@ public:
         m_ucb_noise = p.walksat_ucb_noise();
         m_scale_unsat = p.scale_unsat();
         m_paws_init = p.paws_init();
-        // Andreas: track_unsat is currently disabled because I cannot guarantee that it is not buggy.
-        // If you want to use it, you will also need to change comments in the assertion selection.
-        m_track_unsat = 0;//p.track_unsat();
+        m_track_unsat = p.track_unsat();
     }
 
     /* Andreas: Tried to give some measure for the formula size by the following two methods but both are not used currently.
@@ -453,9 +457,14 @@ public:
 
         TRACE("sls", tout << "Initial model:" << std::endl; show_model(tout); );
 
+        m_where_false.reset();
+        m_list_false.reset();
+        m_unsat_occs.reset();
+        m_where_unsat.reset();
+        m_unsat_constants.reset();
+        m_last_unsat = nullptr;
         if (m_track_unsat)
         {
-            m_list_false = new expr*[sz];
             for (unsigned i = 0; i < sz; i++)
             {
                 if (m_mpz_manager.eq(get_value(as[i]), m_zero))
@@ -500,16 +509,19 @@ public:
     {
         if (m_track_unsat)
         {
-            if (m_where_false.contains(e))
+            unsigned pos;
+            if (m_where_false.find(e, pos))
             {
-                unsigned pos = m_where_false.find(e);
                 m_where_false.erase(e);
-                if (pos != m_where_false.size())
+                expr * q = m_list_false.back();
+                m_list_false.pop_back();
+                if (q != e)
                 {
-                    expr * q = m_list_false[m_where_false.size()];
                     m_list_false[pos] = q;
                     m_where_false.find(q) = pos;
                 }
+                if (!m_walksat)
+                    dec_unsat_occs(e);
             }
         }
     }
@@ -520,13 +532,85 @@ public:
         {
             if (!m_where_false.contains(e))
             {
-                unsigned pos = m_where_false.size();
-                m_list_false[pos] = e;
-                m_where_false.insert(e, pos);
+                m_where_false.insert(e, m_list_false.size());
+                m_list_false.push_back(e);
+                if (!m_walksat)
+                    inc_unsat_occs(e);
             }
         }
     }
 
+    void inc_unsat_occs(expr * e)
+    {
+        ptr_vector<func_decl> const & this_decls = m_constants_occ.find(e);
+        for (func_decl * fd : this_decls) {
+            unsigned & cnt = m_unsat_occs.insert_if_not_there2(fd, 0)->get_data().m_value;
+            if (cnt++ == 0) {
+                m_where_unsat.insert(fd, m_unsat_constants.size());
+                m_unsat_constants.push_back(fd);
+            }
+        }
+    }
+
+    void dec_unsat_occs(expr * e)
+    {
+        ptr_vector<func_decl> const & this_decls = m_constants_occ.find(e);
+        for (func_decl * fd : this_decls) {
+            unsigned & cnt = m_unsat_occs.find(fd);
+            SASSERT(cnt > 0);
+            if (--cnt == 0) {
+                unsigned pos = m_where_unsat.find(fd);
+                m_where_unsat.erase(fd);
+                func_decl * last = m_unsat_constants.back();
+                m_unsat_constants.pop_back();
+                if (last != fd) {
+                    m_unsat_constants[pos] = last;
+                    m_where_unsat.find(last) = pos;
+                }
+            }
+        }
+    }
+
+    // Check the incrementally tracked unsat assertions and constants against a rescan of as.
+    bool check_unsat_tracking(ptr_vector<expr> const & as) {
+        if (!m_track_unsat)
+            return true;
+        unsigned num_false = 0;
+        obj_map<func_decl, unsigned> occs;
+        for (expr * e : as) {
+            bool is_false = m_mpz_manager.eq(get_value(e), m_zero);
+            if (is_false != m_where_false.contains(e))
+                return false;
+            if (!is_false)
+                continue;
+            num_false++;
+            if (m_list_false[m_where_false.find(e)] != e)
+                return false;
+            if (!m_walksat)
+                for (func_decl * fd : m_constants_occ.find(e))
+                    occs.insert_if_not_there2(fd, 0)->get_data().m_value++;
+        }
+        if (num_false != m_list_false.size())
+            return false;
+        if (m_walksat)
+            return true;
+        for (auto const & kv : m_unsat_occs) {
+            unsigned cnt = 0;
+            occs.find(kv.m_key, cnt);
+            if (cnt != kv.m_value)
+                return false;
+        }
+        if (occs.size() != m_unsat_constants.size())
+            return false;
+        for (unsigned i = 0; i < m_unsat_constants.size(); i++) {
+            func_decl * fd = m_unsat_constants[i];
+            unsigned pos;
+            if (!occs.contains(fd) || !m_where_unsat.find(fd, pos) || pos != i)
+                return false;
+        }
+        return true;
+    }
+
     void show_model(std::ostream & out) {
         unsigned sz = get_num_constants();
         for (unsigned i = 0; i < sz; i++) {
@@ -987,6 +1071,11 @@ public:
 
         m_temp_constants.reset();
 
+        if (m_track_unsat) {
+            m_temp_constants.append(m_unsat_constants);
+            return m_temp_constants;
+        }
+
         for (unsigned i = 0; i < sz; i++) {
             expr * q = as[i];
             if (m_mpz_manager.eq(get_value(q), m_one))
@@ -1042,13 +1131,13 @@ public:
         }
         m_temp_constants.reset();
 
+        if (m_track_unsat)
+            return get_tracked_unsat_assertion();
+
         unsigned pos = -1;
         if (m_ucb)
         {
             double max = -1.0;
-            // Andreas: Commented things here might be used for track_unsat data structures as done in SLS for SAT. But seems to have no benefit.
-            /* for (unsigned i = 0; i < m_where_false.size(); i++) {
-                expr * e = m_list_false[i]; */
             for (unsigned i = 0; i < sz; i++) {
                 expr * e = as[i];
                 if (m_mpz_manager.neq(get_value(e), m_one))
@@ -1065,19 +1154,9 @@ public:
 
             m_touched++;
             m_scores.find(as[pos]).touched++;
-            // Andreas: Also part of track_unsat data structures. Additionally disable the previous line!
-            /* m_last_pos = pos;
-            m_scores.find(m_list_false[pos]).touched++;
-            return m_list_false[pos]; */
         }
         else
         {
-            // Andreas: The track_unsat data structures for random assertion selection.
-            /* sz = m_where_false.size();
-            if (sz == 0)
-                return 0;
-            return m_list_false[get_random_uint(16) % sz]; */
-
             unsigned cnt_unsat = 0;
             for (unsigned i = 0; i < sz; i++)
                 if (m_mpz_manager.neq(get_value(as[i]), m_one) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;    
@@ -1085,19 +1164,52 @@ public:
                 return nullptr;
         }
         
-        m_last_pos = pos;
+        m_last_unsat = as[pos];
         return as[pos];
     }
 
+    // Same selection as get_unsat_assertion, but only visits the assertions in m_list_false.
+    expr * get_tracked_unsat_assertion() {
+        unsigned sz = m_list_false.size();
+        if (sz == 0)
+            return nullptr;
+
+        expr * r = nullptr;
+        if (m_ucb)
+        {
+            double max = -1.0;
+            for (expr * e : m_list_false) {
+                value_score & vscore = m_scores.find(e);
+                double q = vscore.score + m_ucb_constant * sqrt(log((double)m_touched) / vscore.touched) + m_ucb_noise * get_random_uint(8); 
+                if (q > max) { max = q; r = e; }
+            }
+            m_touched++;
+            m_scores.find(r).touched++;
+        }
+        else
+            r = m_list_false[get_random_uint(16) % sz];
+
+        m_last_unsat = r;
+        return r;
+    }
+
     expr * get_new_unsat_assertion(ptr_vector<expr> const & as) {
         unsigned sz = as.size();
         if (sz == 1)
             return nullptr;
         m_temp_constants.reset();
         
+        if (m_track_unsat) {
+            expr * r = nullptr;
+            unsigned cnt_unsat = 0;
+            for (expr * e : m_list_false)
+                if ((e != m_last_unsat) && (get_random_uint(16) % ++cnt_unsat == 0)) r = e;
+            return r;
+        }
+
         unsigned cnt_unsat = 0, pos = -1;
         for (unsigned i = 0; i < sz; i++)
-            if ((i != m_last_pos) && m_mpz_manager.neq(get_value(as[i]), m_one) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;
+            if ((as[i] != m_last_unsat) && m_mpz_manager.neq(get_value(as[i]), m_one) && (get_random_uint(16) % ++cnt_unsat == 0)) pos = i;
 
         if (pos == static_cast<unsigned>(-1))
             return nullptr;
@@ -96,7 +96,11 @@ static tactic * mk_qfbv_tactic(ast_manager& m, params_ref const & p, tactic* sat
     ctx_simp_p.set_uint("max_steps", 50000000);
 
 
-    params_ref big_aig_p;
+    // functional reduction removes the redundancy that structural hashing misses.
+    params_ref aig_p;
+    aig_p.set_bool("aig_fraig", true);
+
+    params_ref big_aig_p = aig_p;
     big_aig_p.set_bool("aig_per_assertion", false);
 
     tactic* preamble_st = mk_qfbv_preamble(m, p);
@@ -114,7 +118,7 @@ static tactic * mk_qfbv_tactic(ast_manager& m, params_ref const & p, tactic* sat
                                                                                          mk_solve_eqs_tactic(m)),
                                                                                 local_ctx_p),
                                                                    if_no_proofs(cond(mk_produce_unsat_cores_probe(),
-                                                                                     mk_aig_tactic(),
+                                                                                     using_params(mk_aig_tactic(), aig_p),
                                                                                      using_params(mk_aig_tactic(),
                                                                                                   big_aig_p))))),
                                                      sat),
@@ -162,6 +162,7 @@ tactic * mk_fail_if_undecided_tactic() {
 }
 
 void exec(tactic & t, goal_ref const & in, goal_ref_buffer & result, model_converter_ref & mc, proof_converter_ref & pc, expr_dependency_ref & core) {
+    scoped_memory_tag _mt("tactic");
     t.reset_statistics();
     try {
         t(in, result, mc, pc, core);
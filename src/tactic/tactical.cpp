@@ -22,6 +22,7 @@ Notes:
 #include "util/cooperate.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/z3_omp.h"
+#include "tactic/goal_util.h"
 
 class binary_tactical : public tactic {
 protected:
@@ -460,13 +461,27 @@ enum par_exception_kind {
 };
 
 class par_tactical : public or_else_tactical {
+    size_t m_branch_max_memory; // in bytes, 0 if there is no limit per branch
 
+    struct scoped_branch_memory {
+        size_t m_max;
+        scoped_branch_memory(size_t max, reslimit & lim):m_max(max) { if (m_max != 0) memory::set_thread_max_size(m_max, &lim); }
+        ~scoped_branch_memory() { if (m_max != 0) memory::set_thread_max_size(0, nullptr); }
+    };
 
 public:
-    par_tactical(unsigned num, tactic * const * ts):or_else_tactical(num, ts) {}
+    par_tactical(unsigned num, tactic * const * ts):or_else_tactical(num, ts), m_branch_max_memory(0) {}
     ~par_tactical() override {}
 
-    
+    void updt_params(params_ref const & p) override {
+        or_else_tactical::updt_params(p);
+        m_branch_max_memory = megabytes_to_bytes(p.get_uint("par_branch_max_memory", 0));
+    }
+
+    void collect_param_descrs(param_descrs & r) override {
+        or_else_tactical::collect_param_descrs(r);
+        r.insert("par_branch_max_memory", CPK_UINT, "(default: 0) maximum amount of memory in megabytes a branch of par-or may allocate, a branch exceeding it fails and the remaining branches continue (0 - no limit).");
+    }
 
     void operator()(goal_ref const & in,
                     goal_ref_buffer & result,
@@ -506,7 +521,10 @@ public:
         std::string        ex_msg;
         unsigned           error_code = 0;
         
-        #pragma omp parallel for
+        // dynamic scheduling: when there are more branches than threads, a thread
+        // takes the next pending branch as soon as its current branch stops.
+        scoped_omp_threads threads(sz);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(threads.get())
         for (int i = 0; i < static_cast<int>(sz); i++) {
             goal_ref_buffer     _result;
             model_converter_ref _mc; 
@@ -517,7 +535,10 @@ public:
             tactic & t = *(ts.get(i));
             
             try {
-                t(in_copy, _result, _mc, _pc, _core);
+                {
+                    scoped_branch_memory _bm(m_branch_max_memory, managers[i]->limit());
+                    t(in_copy, _result, _mc, _pc, _core);
+                }
                 bool first = false;
                 #pragma omp critical (par_tactical)
                 {
@@ -678,7 +699,8 @@ public:
             unsigned error_code = 0;
             std::string  ex_msg;
 
-            #pragma omp parallel for
+            scoped_omp_threads threads(r1_size);
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(threads.get())
             for (int i = 0; i < static_cast<int>(r1_size); i++) { 
                 ast_manager & new_m = *(managers[i]);
                 goal_ref new_g = g_copies[i];
@@ -1222,6 +1244,329 @@ tactic * annotate_tactic(char const* name, tactic * t) {
     return alloc(annotate_tactical, name, t);
 }
 
+/**
+   \brief Model converter for the goal produced by split_components_tactical.
+   Every component was processed by its own tactic invocation, and its model converter
+   only knows about the symbols of that component. A model converter may replace the
+   whole model (e.g., model2mc), so instead of composing them, every converter is applied
+   to a copy of the input model and the resulting interpretations are merged.
+*/
+class split_components_model_converter : public model_converter {
+    ast_manager &              m;
+    sref_vector<model_converter> m_mcs;
+public:
+    split_components_model_converter(ast_manager & m, unsigned num, model_converter * const * mcs):
+        m(m) {
+        for (unsigned i = 0; i < num; i++)
+            if (mcs[i] != nullptr)
+                m_mcs.push_back(mcs[i]);
+    }
+
+    void operator()(model_ref & md, unsigned goal_idx) override {
+        SASSERT(goal_idx == 0);
+        model_ref r = alloc(model, m);
+        vector<model_ref> mds;
+        obj_hashtable<func_decl> removed;
+        for (model_converter * mc : m_mcs) {
+            model_ref md_c = md->copy();
+            (*mc)(md_c, 0);
+            // symbols hidden by the converter of a component (e.g., auxiliary
+            // constants it introduced) are not exposed through the other copies.
+            for (unsigned i = 0; i < md->get_num_constants(); i++)
+                if (!md_c->has_interpretation(md->get_constant(i)))
+                    removed.insert(md->get_constant(i));
+            for (unsigned i = 0; i < md->get_num_functions(); i++)
+                if (!md_c->has_interpretation(md->get_function(i)))
+                    removed.insert(md->get_function(i));
+            mds.push_back(md_c);
+        }
+        if (mds.empty())
+            mds.push_back(md);
+        for (model_ref const & md_c : mds) {
+            for (unsigned i = 0; i < md_c->get_num_constants(); i++) {
+                func_decl * c = md_c->get_constant(i);
+                if (!removed.contains(c) && !r->has_interpretation(c))
+                    r->register_decl(c, md_c->get_const_interp(c));
+            }
+            for (unsigned i = 0; i < md_c->get_num_functions(); i++) {
+                func_decl * f = md_c->get_function(i);
+                if (!removed.contains(f) && !r->has_interpretation(f))
+                    r->register_decl(f, md_c->get_func_interp(f)->copy());
+            }
+            for (unsigned i = 0; i < md_c->get_num_uninterpreted_sorts(); i++) {
+                // formulas over the same uninterpreted sort are in the same component.
+                sort * s = md_c->get_uninterpreted_sort(i);
+                if (!r->has_uninterpreted_sort(s))
+                    r->register_usort(s, md_c->get_universe(s).size(), md_c->get_universe(s).c_ptr());
+            }
+        }
+        md = r;
+    }
+
+    void operator()(labels_vec & r, unsigned goal_idx) override {
+        for (model_converter * mc : m_mcs)
+            (*mc)(r, 0);
+    }
+
+    void cancel() override {
+        for (model_converter * mc : m_mcs)
+            mc->cancel();
+    }
+
+    void display(std::ostream & out) override {
+        out << "(split-components-model-converter";
+        for (model_converter * mc : m_mcs) {
+            out << "\n";
+            mc->display(out);
+        }
+        out << ")\n";
+    }
+
+    model_converter * translate(ast_translation & translator) override {
+        ptr_buffer<model_converter> mcs;
+        for (model_converter * mc : m_mcs)
+            mcs.push_back(mc->translate(translator));
+        return alloc(split_components_model_converter, translator.to(), mcs.size(), mcs.c_ptr());
+    }
+};
+
+/**
+   \brief Apply a tactic to every independent component of a goal.
+   Components do not share uninterpreted symbols or sorts, so the goal is satisfiable iff all
+   of them are. Components are processed in parallel (each one in its own ast_manager),
+   and the remaining components are canceled as soon as one of them is shown to be unsat.
+*/
+class split_components_tactical : public unary_tactical {
+
+    // The result of processing one component. The result of a component is kept only
+    // if it is a single goal; otherwise (the tactic case-split), the formulas of the
+    // component are copied unchanged into the combined goal.
+    static void add_component(goal const & comp,
+                              goal_ref_buffer & r,
+                              model_converter * mc,
+                              expr_dependency * core,
+                              goal & result,
+                              model_converter_ref_buffer & mcs,
+                              expr_dependency_ref & result_core) {
+        ast_manager & m = result.m();
+        if (r.size() != 1) {
+            for (unsigned i = 0; i < comp.size(); i++)
+                result.assert_expr(comp.form(i), comp.dep(i));
+            return;
+        }
+        goal const & g = *r[0];
+        for (unsigned i = 0; i < g.size(); i++)
+            result.assert_expr(g.form(i), g.dep(i));
+        result.updt_prec(g.prec());
+        mcs.push_back(mc);
+        if (result.unsat_core_enabled())
+            result_core = m.mk_join(result_core, core);
+    }
+
+    void finalize(goal_ref const & in,
+                  goal * result_goal,
+                  model_converter_ref_buffer & mcs,
+                  goal_ref_buffer & result,
+                  model_converter_ref & mc) {
+        result.push_back(result_goal);
+        if (in->models_enabled())
+            mc = alloc(split_components_model_converter, in->m(), mcs.size(), mcs.c_ptr());
+    }
+
+    void seq_split(goal_ref const & in,
+                   goal_ref_vector const & comps,
+                   goal_ref_buffer & result,
+                   model_converter_ref & mc,
+                   expr_dependency_ref & core) {
+        ast_manager & m = in->m();
+        goal_ref                   new_g = alloc(goal, *in, true);
+        model_converter_ref_buffer mcs;
+        for (goal * comp : comps) {
+            goal_ref_buffer     r;
+            model_converter_ref mc1;
+            proof_converter_ref pc1;
+            expr_dependency_ref core1(m);
+            goal_ref comp_copy = alloc(goal, *comp);
+            m_t->operator()(comp_copy, r, mc1, pc1, core1);
+            if (is_decided_unsat(r)) {
+                result.push_back(r[0]);
+                core = nullptr;
+                return;
+            }
+            add_component(*comp, r, mc1.get(), core1, *new_g, mcs, core);
+        }
+        finalize(in, new_g.get(), mcs, result, mc);
+    }
+
+    void par_split(goal_ref const & in,
+                   goal_ref_vector const & comps,
+                   goal_ref_buffer & result,
+                   model_converter_ref & mc,
+                   expr_dependency_ref & core) {
+        ast_manager & m = in->m();
+        unsigned sz = comps.size();
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_limits                  scl(m.limit());
+        goal_ref_vector                g_copies;
+        tactic_ref_vector              ts;
+        for (unsigned i = 0; i < sz; i++) {
+            ast_manager * new_m = alloc(ast_manager, m, !m.proof_mode());
+            managers.push_back(new_m);
+            ast_translation translator(m, *new_m);
+            g_copies.push_back(comps[i]->translate(translator));
+            ts.push_back(m_t->translate(*new_m));
+            scl.push_child(&new_m->limit());
+        }
+
+        scoped_ptr_vector<goal_ref_buffer>     rs;
+        model_converter_ref_buffer             mc_buffer;
+        scoped_ptr_vector<expr_dependency_ref> core_buffer;
+        rs.resize(sz);
+        mc_buffer.resize(sz);
+        core_buffer.resize(sz);
+
+        unsigned           unsat_id = UINT_MAX;
+        bool               failed   = false;
+        par_exception_kind ex_kind  = DEFAULT_EX;
+        unsigned           error_code = 0;
+        std::string        ex_msg;
+
+        scoped_omp_threads threads(sz);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(threads.get())
+        for (int i = 0; i < static_cast<int>(sz); i++) {
+            ast_manager & new_m = *(managers[i]);
+            goal_ref_buffer *   r = alloc(goal_ref_buffer);
+            model_converter_ref mc1;
+            proof_converter_ref pc1;
+            expr_dependency_ref core1(new_m);
+            rs.set(i, r);
+            bool stop = false;
+            try {
+                ts[i]->operator()(g_copies[i], *r, mc1, pc1, core1);
+                if (is_decided_unsat(*r)) {
+                    #pragma omp critical (split_components_tactical)
+                    {
+                        if (unsat_id == UINT_MAX) {
+                            unsat_id = i;
+                            stop     = true;
+                        }
+                    }
+                }
+                mc_buffer.set(i, mc1.get());
+                core_buffer.set(i, alloc(expr_dependency_ref, core1));
+            }
+            catch (z3_exception & ex) {
+                #pragma omp critical (split_components_tactical)
+                {
+                    // exceptions raised after an unsat component canceled the
+                    // others, or after another component failed, are ignored.
+                    if (!failed && unsat_id == UINT_MAX) {
+                        failed = true;
+                        stop   = true;
+                        if (ex.has_error_code()) {
+                            ex_kind    = ERROR_EX;
+                            error_code = ex.error_code();
+                        }
+                        else if (dynamic_cast<tactic_exception*>(&ex)) {
+                            ex_kind = TACTIC_EX;
+                            ex_msg  = ex.msg();
+                        }
+                        else {
+                            ex_kind = DEFAULT_EX;
+                            ex_msg  = ex.msg();
+                        }
+                    }
+                }
+            }
+            if (stop) {
+                for (unsigned j = 0; j < sz; j++) {
+                    if (static_cast<unsigned>(i) != j) {
+                        managers[j]->limit().cancel();
+                    }
+                }
+            }
+        }
+
+        if (unsat_id != UINT_MAX) {
+            ast_translation translator(*(managers[unsat_id]), m, false);
+            result.push_back((*rs[unsat_id])[0]->translate(translator));
+            core = nullptr;
+            return;
+        }
+        if (failed) {
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            case TACTIC_EX: throw tactic_exception(ex_msg.c_str());
+            default:
+                throw default_exception(ex_msg.c_str());
+            }
+        }
+
+        goal_ref                   new_g = alloc(goal, *in, true);
+        model_converter_ref_buffer mcs;
+        for (unsigned i = 0; i < sz; i++) {
+            ast_translation translator(*(managers[i]), m, false);
+            goal_ref_buffer r;
+            goal_ref_buffer & r_i = *rs[i];
+            for (unsigned k = 0; k < r_i.size(); k++)
+                r.push_back(r_i[k]->translate(translator));
+            model_converter_ref mc1 = mc_buffer[i] ? mc_buffer[i]->translate(translator) : nullptr;
+            expr_dependency_translation td(translator);
+            expr_dependency_ref core1(m);
+            core1 = td(*core_buffer[i]);
+            add_component(*comps[i], r, mc1.get(), core1, *new_g, mcs, core);
+        }
+        finalize(in, new_g.get(), mcs, result, mc);
+    }
+
+public:
+    split_components_tactical(tactic * t):unary_tactical(t) {}
+
+    void operator()(goal_ref const & in,
+                    goal_ref_buffer & result,
+                    model_converter_ref & mc,
+                    proof_converter_ref & pc,
+                    expr_dependency_ref & core) override {
+        // proofs of the components cannot be combined, and an inconsistent goal
+        // has nothing to split.
+        unsigned_vector comp;
+        unsigned num_comps = 1;
+        if (!in->proofs_enabled() && !in->inconsistent())
+            num_comps = get_goal_components(*in, comp);
+        if (num_comps <= 1) {
+            m_t->operator()(in, result, mc, pc, core);
+            return;
+        }
+        result.reset();
+        mc   = nullptr;
+        pc   = nullptr;
+        core = nullptr;
+
+        goal_ref_vector comps;
+        for (unsigned c = 0; c < num_comps; c++)
+            comps.push_back(alloc(goal, *in, true));
+        for (unsigned i = 0; i < in->size(); i++)
+            comps[comp[i]]->assert_expr(in->form(i), in->dep(i));
+
+        bool use_seq;
+#ifdef _NO_OMP_
+        use_seq = true;
+#else
+        use_seq = 0 != omp_in_parallel();
+#endif
+        if (use_seq)
+            seq_split(in, comps, result, mc, core);
+        else
+            par_split(in, comps, result, mc, core);
+    }
+
+    tactic * translate(ast_manager & m) override { return translate_core<split_components_tactical>(m); }
+};
+
+tactic * split_components(tactic * t) {
+    return alloc(split_components_tactical, t);
+}
+
 class cond_tactical : public binary_tactical {
     probe * m_p;
 public:
@@ -1262,6 +1607,54 @@ tactic * when(probe * p, tactic * t) {
     return cond(p, t, mk_skip_tactic());
 }
 
+class select_max_tactical : public nary_tactical {
+    ptr_vector<probe> m_scores;
+public:
+    select_max_tactical(unsigned num, probe * const * scores, tactic * const * ts):
+        nary_tactical(num, ts) {
+        SASSERT(num > 0);
+        for (unsigned i = 0; i < num; i++) {
+            SASSERT(scores[i]);
+            m_scores.push_back(scores[i]);
+            scores[i]->inc_ref();
+        }
+    }
+
+    ~select_max_tactical() override {
+        for (probe * p : m_scores)
+            p->dec_ref();
+    }
+
+    void operator()(goal_ref const & in,
+                    goal_ref_buffer & result,
+                    model_converter_ref & mc,
+                    proof_converter_ref & pc,
+                    expr_dependency_ref & core) override {
+        unsigned best = 0;
+        double best_score = 0;
+        for (unsigned i = 0; i < m_scores.size(); i++) {
+            double score = m_scores[i]->operator()(*(in.get())).get_value();
+            TRACE("select_max", tout << "tactic " << i << " score: " << score << "\n";);
+            if (i == 0 || score > best_score) {
+                best = i;
+                best_score = score;
+            }
+        }
+        m_ts[best]->operator()(in, result, mc, pc, core);
+    }
+
+    tactic * translate(ast_manager & m) override {
+        ptr_buffer<tactic> new_ts;
+        for (tactic * t : m_ts)
+            new_ts.push_back(t->translate(m));
+        return alloc(select_max_tactical, new_ts.size(), m_scores.c_ptr(), new_ts.c_ptr());
+    }
+};
+
+tactic * select_max(unsigned num, probe * const * scores, tactic * const * ts) {
+    return alloc(select_max_tactical, num, scores, ts);
+}
+
 class fail_if_tactic : public tactic {
     probe * m_p;
 public:
@@ -60,6 +60,15 @@ tactic * par(tactic * t1, tactic * t2, tactic * t3, tactic * t4);
 tactic * par_and_then(unsigned num, tactic * const * ts);
 tactic * par_and_then(tactic * t1, tactic * t2);
 
+/**
+   \brief Apply \c t to every independent component of the input goal, i.e., to every
+   maximal set of formulas that share uninterpreted symbols, and merge the results.
+   Components are processed in parallel, and the input goal is unsat as soon as one
+   of them is. Goals with a single component, or with proof production enabled, are
+   given to \c t directly.
+*/
+tactic * split_components(tactic * t);
+
 tactic * try_for(tactic * t, unsigned msecs);
 tactic * clean(tactic * t);
 tactic * using_params(tactic * t, params_ref const & p);
@@ -72,6 +81,10 @@ tactic * fail_if_not(probe * p);
 tactic * cond(probe * p, tactic * t1, tactic * t2);
 // Alias for cond(p, t, mk_skip_tactic())
 tactic * when(probe * p, tactic * t);
+// Execute the tactic ts[i] whose score scores[i] is the largest on the goal.
+// The first one is used if several have the largest score.
+// Probe expressions over goal features (e.g., linear models) can be used as scores.
+tactic * select_max(unsigned num, probe * const * scores, tactic * const * ts);
 
 // alias for (or-else t skip)
 tactic * skip_if_failed(tactic * t);
@@ -0,0 +1,53 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    aig.cpp
+
+Abstract:
+
+    Test functional reduction of AIGs.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include "tactic/aig/aig.h"
+
+static expr_ref fraig(ast_manager & m, expr * e) {
+    aig_manager mng(m);
+    aig_ref r = mng.mk_aig(e);
+    mng.fraig(r, 1000);
+    mng.max_sharing(r);
+    expr_ref result(m);
+    mng.to_formula(r, result);
+    TRACE("aig", tout << mk_pp(e, m) << "\n--->\n" << result << "\n";);
+    return result;
+}
+
+static void tst1() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    sort * B = m.mk_bool_sort();
+    expr_ref a(m.mk_const(symbol("a"), B), m);
+    expr_ref b(m.mk_const(symbol("b"), B), m);
+    expr_ref c(m.mk_const(symbol("c"), B), m);
+    expr_ref d(m.mk_const(symbol("d"), B), m);
+    // distributivity is not found by structural hashing.
+    expr_ref f1(m.mk_or(m.mk_and(a, b), m.mk_and(a, c)), m);
+    expr_ref f2(m.mk_and(a, m.mk_or(b, c)), m);
+    ENSURE(m.is_false(fraig(m, m.mk_not(m.mk_iff(f1, f2)))));
+    ENSURE(m.is_true(fraig(m, m.mk_iff(f1, f2))));
+    // majority written in two ways.
+    expr_ref maj1(m.mk_or(m.mk_and(a, b), m.mk_and(c, m.mk_or(a, b))), m);
+    expr_ref maj2(m.mk_or(m.mk_and(a, c), m.mk_and(b, m.mk_or(a, c))), m);
+    ENSURE(m.is_false(fraig(m, m.mk_xor(maj1, maj2))));
+    // non-equivalent nodes with equal signatures on some patterns are kept.
+    expr_ref g(m.mk_and(m.mk_iff(f1, m.mk_and(a, d)), d), m);
+    expr_ref r = fraig(m, g);
+    ENSURE(!m.is_false(r) && !m.is_true(r));
+}
+
+void tst_aig() {
+    tst1();
+}
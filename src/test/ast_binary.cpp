@@ -0,0 +1,214 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    ast_binary.cpp
+
+Abstract:
+
+    Test binary serialization of expressions.
+
+--*/
+#include<sstream>
+#include<cstring>
+#include "ast/ast_binary.h"
+#include "ast/ast_translation.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/array_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include "api/z3.h"
+
+static void check_round_trip(ast_manager & m, expr_ref_vector const & es) {
+    std::stringstream strm;
+    ast_binary_write(strm, es);
+
+    // read into the same manager: hash-consing gives back the same terms.
+    expr_ref_vector r1(m);
+    ast_binary_read(strm, m, r1);
+    ENSURE(r1.size() == es.size());
+    for (unsigned i = 0; i < es.size(); ++i) {
+        ENSURE(r1.get(i) == es.get(i));
+    }
+
+    // read into a fresh manager and compare with ast_translation.
+    ast_manager m2;
+    reg_decl_plugins(m2);
+    expr_ref_vector r2(m2);
+    std::istringstream in(strm.str());
+    ast_binary_read(in, m2, r2);
+    ENSURE(r2.size() == es.size());
+    ast_translation tr(m, m2);
+    for (unsigned i = 0; i < es.size(); ++i) {
+        ENSURE(tr(es.get(i)) == r2.get(i));
+    }
+}
+
+static void tst1() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    bv_util bv(m);
+    array_util ar(m);
+
+    sort_ref I(a.mk_int(), m), R(a.mk_real(), m), B(bv.mk_sort(12), m);
+    sort_ref U(m.mk_uninterpreted_sort(symbol("U")), m);
+    sort_ref A(ar.mk_array_sort(I, B), m);
+    func_decl_ref f(m.mk_func_decl(symbol("f"), U, I), m);
+    expr_ref x(m.mk_const(symbol("x"), I), m), y(m.mk_const(symbol("y"), R), m);
+    expr_ref u(m.mk_const(symbol("u"), U), m), arr(m.mk_const(symbol("arr"), A), m);
+    expr_ref b(m.mk_const(symbol(3), B), m);
+
+    expr_ref fu(m.mk_app(f, u.get()), m);
+    expr_ref shared(a.mk_add(x.get(), fu.get()), m);
+    expr_ref_vector es(m);
+    es.push_back(a.mk_le(shared, a.mk_numeral(rational(-7), true)));
+    es.push_back(a.mk_lt(a.mk_to_real(shared), a.mk_mul(y.get(), a.mk_numeral(rational(3, 4), false))));
+    expr * sel_args[2] = { arr.get(), shared.get() };
+    es.push_back(m.mk_eq(ar.mk_select(2, sel_args), bv.mk_bv_add(b, bv.mk_numeral(rational(4095), 12))));
+    expr * dist_args[3] = { x.get(), shared.get(), a.mk_numeral(rational(1), true) };
+    es.push_back(m.mk_distinct(3, dist_args));
+
+    sort * qs[2] = { I.get(), U.get() };
+    symbol qn[2] = { symbol("i"), symbol("v") };
+    expr_ref body(a.mk_ge(a.mk_add(m.mk_var(1, I), m.mk_app(f, static_cast<expr*>(m.mk_var(0, U)))), x), m);
+    app * pat_arg = m.mk_app(f, static_cast<expr*>(m.mk_var(0, U)));
+    expr_ref pat(m.mk_pattern(1, &pat_arg), m);
+    expr * pats[1] = { pat.get() };
+    es.push_back(m.mk_forall(2, qs, qn, body, 3, symbol("q1"), symbol::null, 1, pats));
+    es.push_back(m.mk_exists(2, qs, qn, body));
+
+    check_round_trip(m, es);
+}
+
+static void tst_empty() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    check_round_trip(m, expr_ref_vector(m));
+}
+
+static void tst_malformed() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector es(m);
+    es.push_back(m.mk_const(symbol("p"), m.mk_bool_sort()));
+    std::stringstream strm;
+    ast_binary_write(strm, es);
+    std::string s = strm.str();
+    for (unsigned len = 0; len < s.size(); ++len) {
+        std::istringstream in(s.substr(0, len));
+        expr_ref_vector r(m);
+        bool failed = false;
+        try {
+            ast_binary_read(in, m, r);
+        }
+        catch (default_exception &) {
+            failed = true;
+        }
+        ENSURE(failed);
+    }
+}
+
+// hand-written input, see the layout in ast/ast_binary.cpp.
+class ab_stream {
+    std::string m_data;
+public:
+    ab_stream() { m_data = "Z3AB"; num(2); }
+    ab_stream & byte(unsigned char c) { m_data.push_back(c); return *this; }
+    ab_stream & num(unsigned n) {
+        for (; n >= 0x80; n >>= 7)
+            byte(static_cast<unsigned char>(n | 0x80));
+        return byte(static_cast<unsigned char>(n));
+    }
+    ab_stream & sint(int n) { return num((static_cast<unsigned>(n) << 1) ^ static_cast<unsigned>(n >> 31)); }
+    ab_stream & sym(char const * s) { byte(2); num(static_cast<unsigned>(strlen(s))); m_data += s; return *this; }
+    // theory sort or declaration header: family, kind, private parameters, no parameters.
+    ab_stream & theory(char const * family, int k, bool priv = false) { byte(1); sym(family); sint(k); byte(priv); return num(0); }
+    std::string const & str() const { return m_data; }
+};
+
+static bool read_fails(ast_manager & m, ab_stream const & s) {
+    std::istringstream in(s.str());
+    expr_ref_vector r(m);
+    try {
+        ast_binary_read(in, m, r);
+    }
+    catch (default_exception & ex) {
+        ENSURE(strncmp(ex.msg(), "invalid binary AST input", 24) == 0);
+        return true;
+    }
+    return false;
+}
+
+// (<= (+ arg arg) x) with nodes 0 Int, 1 Bool, 2 p : Bool, 3 x : Int, 4 p, 5 x, 6 +, 7 (+ arg arg), 8 <=, 9 (<= 7 5)
+static ab_stream mk_sum(char const * add_family, int add_kind, bool add_private, unsigned arg) {
+    ab_stream s;
+    s.byte(1).sym("Int").theory("arith", INT_SORT);
+    s.byte(1).sym("Bool").theory("basic", BOOL_SORT);
+    s.byte(2).sym("p").num(0).num(1).byte(0);
+    s.byte(2).sym("x").num(0).num(0).byte(0);
+    s.byte(3).num(2).num(0);
+    s.byte(3).num(3).num(0);
+    s.byte(2).sym("+").num(2).num(0).num(0).num(0).theory(add_family, add_kind, add_private);
+    s.byte(3).num(6).num(2).num(arg).num(arg);
+    s.byte(2).sym("<=").num(2).num(0).num(0).num(1).theory("arith", OP_LE);
+    s.byte(3).num(8).num(2).num(7).num(5);
+    s.byte(6).num(9).byte(0);
+    return s;
+}
+
+// theory sorts and declarations are rebuilt by the plugins, and rejected if they do not exist.
+static void tst_theories() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    ENSURE(!read_fails(m, mk_sum("arith", OP_ADD, false, 5)));
+    // Boolean arguments to +
+    ENSURE(read_fails(m, mk_sum("arith", OP_ADD, false, 4)));
+    // unknown theory, kind, or private parameters that the plugin does not use
+    ENSURE(read_fails(m, mk_sum("nosuch", OP_ADD, false, 5)));
+    ENSURE(read_fails(m, mk_sum("arith", 1000, false, 5)));
+    ENSURE(read_fails(m, mk_sum("arith", OP_ADD, true, 5)));
+    ENSURE(read_fails(m, mk_sum("arith", OP_LE, false, 5)));
+    ENSURE(read_fails(m, ab_stream().byte(1).sym("Int").theory("arith", 1000)));
+    ENSURE(read_fails(m, ab_stream().byte(1).sym("Int").theory("arith", INT_SORT, true)));
+    ENSURE(read_fails(m, ab_stream().byte(1).sym("Int").theory("nosuch", INT_SORT)));
+}
+
+// round trip through a file with the API entry points.
+static void tst_api() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_sort I = Z3_mk_int_sort(ctx);
+    Z3_ast x = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "x"), I);
+    Z3_ast y = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "y"), I);
+    Z3_ast xy[2] = { x, y };
+    Z3_ast s = Z3_mk_add(ctx, 2, xy);
+    Z3_ast fmls[2] = { Z3_mk_gt(ctx, s, x), Z3_mk_lt(ctx, s, Z3_mk_int(ctx, 5, I)) };
+    char const * file_name = "ast_binary_test.z3b";
+    Z3_write_binary_file(ctx, file_name, 2, fmls);
+    ENSURE(Z3_get_error_code(ctx) == Z3_OK);
+    Z3_ast_vector r = Z3_parse_binary_file(ctx, file_name);
+    ENSURE(Z3_get_error_code(ctx) == Z3_OK);
+    Z3_ast_vector_inc_ref(ctx, r);
+    ENSURE(Z3_ast_vector_size(ctx, r) == 2);
+    for (unsigned i = 0; i < 2; ++i)
+        ENSURE(Z3_is_eq_ast(ctx, Z3_ast_vector_get(ctx, r, i), fmls[i]));
+    Z3_ast_vector_dec_ref(ctx, r);
+    remove(file_name);
+
+    Z3_set_error_handler(ctx, nullptr);
+    Z3_parse_binary_file(ctx, "ast_binary_missing.z3b");
+    ENSURE(Z3_get_error_code(ctx) == Z3_PARSER_ERROR);
+    Z3_del_context(ctx);
+}
+
+void tst_ast_binary() {
+    tst1();
+    tst_empty();
+    tst_malformed();
+    tst_theories();
+    tst_api();
+}
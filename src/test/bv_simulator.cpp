@@ -0,0 +1,94 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    bv_simulator.cpp
+
+Abstract:
+
+    Test bit-parallel simulation against the rewriter.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/bv_simulator.h"
+#include "ast/ast_pp.h"
+#include "ast/rewriter/th_rewriter.h"
+
+// every binary operation agrees with the rewriter on constant arguments,
+// including the division by zero cases.
+static void tst_ops() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    th_rewriter rw(m);
+    unsigned sz = 6;
+    sort_ref s(bv.mk_sort(sz), m);
+    expr_ref x(m.mk_const(symbol("x"), s), m);
+    expr_ref y(m.mk_const(symbol("y"), s), m);
+    decl_kind ops[] = { OP_BADD, OP_BSUB, OP_BMUL, OP_BSDIV, OP_BUDIV, OP_BSREM, OP_BUREM, OP_BSMOD,
+                        OP_ULEQ, OP_SLEQ, OP_ULT, OP_SGT, OP_BAND, OP_BOR, OP_BXOR, OP_BNAND, OP_BXNOR,
+                        OP_CONCAT, OP_BCOMP, OP_BSHL, OP_BLSHR, OP_BASHR };
+    uint64 xs[bv_simulator::num_lanes], ys[bv_simulator::num_lanes];
+    for (unsigned i = 0; i < bv_simulator::num_lanes; i++) {
+        xs[i] = (i * 37) % 64;
+        ys[i] = i < 8 ? i : (i * 11 + 5) % 64;
+    }
+    for (decl_kind k : ops) {
+        bv_simulator sim(m);
+        sim.set_input(x, xs);
+        sim.set_input(y, ys);
+        expr_ref t(m.mk_app(bv.get_fid(), k, x, y), m);
+        sim(t);
+        uint64 const * vals = sim.get_values(t);
+        for (unsigned i = 0; i < bv_simulator::num_lanes; i++) {
+            expr_ref v(m.mk_app(bv.get_fid(), k, bv.mk_numeral(rational(xs[i], rational::ui64()), sz),
+                                bv.mk_numeral(rational(ys[i], rational::ui64()), sz)), m);
+            rw(v);
+            rational r;
+            unsigned r_sz;
+            if (m.is_bool(v))
+                r = rational(m.is_true(v) ? 1 : 0);
+            else
+                ENSURE(bv.is_numeral(v, r, r_sz));
+            CTRACE("bv_simulator", r != rational(vals[i], rational::ui64()),
+                   tout << t << " " << xs[i] << " " << ys[i] << " -> " << r << " / " << vals[i] << "\n";);
+            ENSURE(r == rational(vals[i], rational::ui64()));
+        }
+    }
+}
+
+static void tst_candidates() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    sort_ref s(bv.mk_sort(32), m);
+    expr_ref x(m.mk_const(symbol("x"), s), m);
+    expr_ref y(m.mk_const(symbol("y"), s), m);
+    expr_ref xy(bv.mk_bv_add(x, y), m), yx(bv.mk_bv_add(y, x), m);
+    expr_ref x2(bv.mk_bv_mul(x, bv.mk_numeral(rational(2), 32)), m);
+    expr_ref x_shl(bv.mk_bv_shl(x, bv.mk_numeral(rational(1), 32)), m);
+    expr_ref x3(bv.mk_bv_mul(x, bv.mk_numeral(rational(3), 32)), m);
+    expr_ref zero(m.mk_app(bv.get_fid(), OP_BAND, x, bv.mk_bv_not(x)), m);
+    expr * ts[6] = { xy, yx, x2, x_shl, x3, zero };
+    bv_simulator sim(m);
+    sim(6, ts);
+    uint64 v;
+    ENSURE(sim.is_constant(zero, v) && v == 0);
+    ENSURE(!sim.is_constant(x, v));
+    ENSURE(!sim.is_constant(xy, v));
+    vector<ptr_vector<expr> > classes;
+    sim.get_candidate_classes(classes);
+    bool found_add = false, found_mul = false;
+    for (auto const & c : classes) {
+        ENSURE(!c.contains(x3));
+        if (c.contains(xy)) found_add = c.size() == 2 && c.contains(yx);
+        if (c.contains(x2)) found_mul = c.size() == 2 && c.contains(x_shl);
+    }
+    ENSURE(found_add && found_mul);
+}
+
+void tst_bv_simulator() {
+    tst_ops();
+    tst_candidates();
+}
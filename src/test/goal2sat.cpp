@@ -0,0 +1,95 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    goal2sat.cpp
+
+Abstract:
+
+    Test the polarity aware CNF encoding of goal2sat on random formulas.
+
+--*/
+#include "sat/tactic/goal2sat.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/expr_safe_replace.h"
+#include "util/util.h"
+
+static expr_ref mk_random_formula(ast_manager & m, random_gen & r, expr_ref_vector const & vars, unsigned num_nodes) {
+    expr_ref_vector pool(m);
+    pool.append(vars);
+    for (unsigned i = 0; i < num_nodes; ++i) {
+        expr * a = pool.get(r(pool.size()));
+        expr * b = pool.get(r(pool.size()));
+        expr * c = pool.get(r(pool.size()));
+        switch (r(5)) {
+        case 0: pool.push_back(m.mk_not(a)); break;
+        case 1: pool.push_back(m.mk_and(a, b, c)); break;
+        case 2: pool.push_back(m.mk_or(a, m.mk_not(b))); break;
+        case 3: pool.push_back(m.mk_ite(a, b, c)); break;
+        default: pool.push_back(m.mk_iff(a, b)); break;
+        }
+    }
+    // combine the last nodes so that shared sub-formulas occur with both polarities.
+    return expr_ref(m.mk_and(pool.back(), m.mk_or(m.mk_not(pool.get(pool.size() - 2)), pool.get(pool.size() - 3))), m);
+}
+
+static lbool solve(goal const & g, bool polarity, unsigned & num_clauses, expr * fml, expr_ref_vector const & vars) {
+    ast_manager & m = g.m();
+    params_ref p;
+    p.set_bool("cnf_polarity", polarity);
+    reslimit rl;
+    sat::solver s(p, rl, nullptr);
+    atom2bool_var map(m);
+    goal2sat::dep2asm_map dep2asm;
+    goal2sat g2s;
+    g2s(g, p, s, map, dep2asm);
+    num_clauses = s.num_clauses();
+    lbool r = s.check();
+    if (r == l_true) {
+        // the model of the CNF is a model of the formula.
+        sat::model const & mdl = s.get_model();
+        expr_safe_replace sub(m);
+        for (expr * v : vars) {
+            sat::bool_var b = map.to_bool_var(v);
+            if (b != sat::null_bool_var)
+                sub.insert(v, mdl[b] == l_true ? m.mk_true() : m.mk_false());
+        }
+        expr_ref val(m);
+        sub(fml, val);
+        th_rewriter rw(m);
+        rw(val);
+        CTRACE("goal2sat", !m.is_true(val), tout << mk_pp(fml, m) << "\n" << val << "\n";);
+        ENSURE(m.is_true(val));
+    }
+    return r;
+}
+
+void tst_goal2sat() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_gen r(0);
+    expr_ref_vector vars(m);
+    for (unsigned i = 0; i < 6; ++i)
+        vars.push_back(m.mk_const(symbol((std::string("p") + std::to_string(i)).c_str()), m.mk_bool_sort()));
+    unsigned num_sat = 0, num_unsat = 0, fewer = 0;
+    for (unsigned i = 0; i < 300; ++i) {
+        expr_ref fml = mk_random_formula(m, r, vars, 12);
+        goal g(m);
+        g.assert_expr(fml);
+        if (g.inconsistent())
+            continue;
+        unsigned sz_pg = 0, sz_full = 0;
+        lbool r1 = solve(g, true, sz_pg, fml, vars);
+        lbool r2 = solve(g, false, sz_full, fml, vars);
+        CTRACE("goal2sat", r1 != r2, tout << mk_pp(fml, m) << "\n";);
+        ENSURE(r1 == r2);
+        ENSURE(sz_pg <= sz_full);
+        if (sz_pg < sz_full) ++fewer;
+        if (r1 == l_true) ++num_sat; else ++num_unsat;
+    }
+    std::cout << "sat: " << num_sat << " unsat: " << num_unsat << " smaller encodings: " << fewer << "\n";
+    ENSURE(num_sat > 0 && num_unsat > 0 && fewer > 0);
+}
@@ -151,6 +151,7 @@ int main(int argc, char ** argv) {
     TST(rational);
     TST(inf_rational);
     TST(ast);
+    TST(ast_binary);
     TST(optional);
     TST(bit_vector);
     TST(fixed_bit_vector);
@@ -244,7 +245,17 @@ int main(int argc, char ** argv) {
     TST_ARGV(lp);
     TST(get_consequences);
     TST(pb2bv);
+    TST(propagate_values);
+    TST(split_components);
+    TST(aig);
+    TST(bv_simulator);
+    TST(goal2sat);
+    TST(select_max);
+    TST(th_rewriter);
+    TST(smt2_scanner);
+    TST(sls_tracker);
     TST_ARGV(cnf_backbones);
+    TST_ARGV(mbp_bench);
     //TST_ARGV(hs);
 }
 
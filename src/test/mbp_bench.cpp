@@ -0,0 +1,684 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    mbp_bench.cpp
+
+Abstract:
+
+    Benchmark for the linear arithmetic projection implementations:
+
+    - mbo:    opt::model_based_opt::project
+    - arith:  qe::arith_project_plugin
+    - mbp:    qe::mbp
+    - spacer: spacer's qe::arith_project (Loos-Weispfenning)
+    - fm:     Fourier-Motzkin elimination using the fm tactic
+
+    Each implementation is run on the same set of problems and the
+    time, memory, output size and number of projected variables left in
+    the output are reported. Every projection is checked against the
+    original literals: it must entail their projection, that is the
+    original literals with the projected constants existentially
+    quantified, which is decided by the qsat tactic. In addition, a
+    model based projection must hold in the model, and the output of fm
+    must be implied by the original literals. The entailment is not
+    checked for fm outputs with projected constants left, since qsat
+    can take minutes on them. Failed checks are reported as invalid.
+
+    Problems are either generated and taken from the recorded problems
+    below (the default) or read from SMT-LIB2 files given on the command
+    line. For recorded problems and files, the assertions are the
+    literals, a model is computed using the SMT solver, and the first
+    half of the arithmetic constants are projected.
+
+    With the default parameters the output sizes are compared against a
+    baseline and the benchmark fails if an implementation produces
+    invalid projections or exceeds its baseline by more than 20%.
+
+    Usage:
+
+       test-z3 mbp_bench [seed:<n>] [count:<n>] [vars:<n>] [ineqs:<n>] [project:<n>] [file.smt2]*
+
+    The options use ':' because test-z3 takes arguments of the form
+    name=value as global parameters.
+
+--*/
+
+#include "math/simplex/model_based_opt.h"
+#include "qe/qe_arith.h"
+#include "qe/qe_mbp.h"
+#include "muz/spacer/spacer_qe_project.h"
+#include "tactic/arith/fm_tactic.h"
+#include "qe/qsat.h"
+#include "tactic/tactic.h"
+#include "smt/smt_kernel.h"
+#include "smt/params/smt_params.h"
+#include "parsers/smt2/smt2parser.h"
+#include "cmd_context/cmd_context.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/for_each_expr.h"
+#include "ast/ast_util.h"
+#include "ast/occurs.h"
+#include "ast/expr_abstract.h"
+#include "model/model.h"
+#include "util/stopwatch.h"
+#include "util/memory_manager.h"
+#include "util/uint_set.h"
+#include "util/util.h"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+
+namespace {
+
+    typedef opt::model_based_opt::var var_t;
+
+    /**
+       \brief a projection problem: a conjunction of linear arithmetic literals,
+       a model satisfying them, and the constants to project.
+       When the literals are generated, the rows are kept as well such that
+       model_based_opt can be run directly on them.
+    */
+    struct mbp_problem {
+        expr_ref_vector       m_lits;
+        model_ref             m_model;
+        app_ref_vector        m_vars;    // all constants
+        unsigned              m_num_project;  // the first m_num_project vars are projected
+        bool                  m_has_rows;
+        vector<rational>      m_values;
+        vector<vector<var_t>> m_rows;
+        vector<rational>      m_coeffs;
+        svector<opt::ineq_type> m_types;
+
+        mbp_problem(ast_manager& m): m_lits(m), m_vars(m), m_num_project(0), m_has_rows(false) {}
+
+        void get_projected(app_ref_vector& vars) const {
+            vars.reset();
+            for (unsigned i = 0; i < m_num_project; ++i) {
+                vars.push_back(m_vars.get(i));
+            }
+        }
+    };
+
+    struct mbp_stats {
+        char const*        m_name;
+        unsigned           m_num_problems;
+        unsigned           m_num_failed;
+        double             m_seconds;
+        unsigned           m_output_size;
+        unsigned           m_residual_vars;
+        long long          m_memory;      // change of the allocated memory, summed over the calls
+        unsigned long long m_max_memory;  // increase of the peak memory, summed over the calls
+        mbp_stats(char const* name):
+            m_name(name), m_num_problems(0), m_num_failed(0), m_seconds(0),
+            m_output_size(0), m_residual_vars(0), m_memory(0), m_max_memory(0) {}
+
+        void display(std::ostream& out) const {
+            out << "(mbp-bench :impl " << m_name
+                << " :problems " << m_num_problems
+                << " :time " << m_seconds
+                << " :output-size " << m_output_size
+                << " :residual-vars " << m_residual_vars
+                << " :memory " << m_memory
+                << " :max-memory " << m_max_memory;
+            if (m_num_failed > 0) {
+                out << " :invalid " << m_num_failed;
+            }
+            out << ")\n";
+        }
+    };
+
+    /**
+       \brief measure the time and memory of a single projection call.
+       The benchmark is single-threaded, so the changes of the allocated and
+       of the peak memory during the call are caused by the call. The counters
+       are synchronized before and after the call; during the call the peak is
+       only updated every 100KB or so of allocations.
+    */
+    class scoped_measure {
+        mbp_stats&         m_stats;
+        stopwatch          m_watch;
+        unsigned long long m_memory;
+        unsigned long long m_max_memory;
+    public:
+        scoped_measure(mbp_stats& st): m_stats(st) {
+            memory::synchronize_thread_counters();
+            m_memory     = memory::get_allocation_size();
+            m_max_memory = memory::get_max_used_memory();
+            m_watch.start();
+        }
+        ~scoped_measure() {
+            m_watch.stop();
+            m_stats.m_seconds += m_watch.get_seconds();
+            memory::synchronize_thread_counters();
+            m_stats.m_memory += static_cast<long long>(memory::get_allocation_size()) - static_cast<long long>(m_memory);
+            m_stats.m_max_memory += memory::get_max_used_memory() - m_max_memory;
+            m_stats.m_num_problems++;
+        }
+    };
+
+    /**
+       \brief output sizes and residual variables of the default run (seed 0,
+       20 generated problems and the recorded problems).
+    */
+    struct mbp_baseline {
+        char const* m_name;
+        unsigned    m_output_size;
+        unsigned    m_residual_vars;
+    };
+
+    static const mbp_baseline g_baseline[] = {
+        { "mbo",    1560,   0 },
+        { "arith",  3580,   0 },
+        { "mbp",    3580,   0 },
+        { "spacer", 4149,   0 },
+        { "fm",     3328, 101 },
+    };
+
+    /**
+       \brief hand-written problems in the style of the projections done by
+       spacer and opt: bound chains, equalities, a loop invariant and shared bounds.
+    */
+    static char const* g_recorded[] = {
+        // bounds chain
+        "(declare-const x Real) (declare-const y Real) (declare-const z Real)\n"
+        "(declare-const a Real) (declare-const b Real) (declare-const c Real)\n"
+        "(assert (<= a x)) (assert (< x y)) (assert (<= y (+ z 1.0)))\n"
+        "(assert (<= (* 2.0 z) b)) (assert (< b (+ c 10.0))) (assert (>= c (- a 3.0)))\n",
+        // equalities and disequality free strict bounds
+        "(declare-const x Real) (declare-const y Real) (declare-const u Real) (declare-const v Real)\n"
+        "(assert (= (+ x (* 3.0 y)) (- u v))) (assert (< (- x y) 4.0))\n"
+        "(assert (> (+ (* 2.0 x) u) 1.0)) (assert (<= (- (* 5.0 y) v) u)) (assert (>= v 0.0))\n",
+        // loop invariant strengthening
+        "(declare-const i Real) (declare-const n Real) (declare-const s Real) (declare-const i1 Real) (declare-const s1 Real)\n"
+        "(declare-const m Real)\n"
+        "(assert (<= 0.0 i)) (assert (< i n)) (assert (= i1 (+ i 1.0))) (assert (= s1 (+ s i)))\n"
+        "(assert (<= s1 (* 2.0 m))) (assert (>= (+ s n) m)) (assert (<= n 100.0))\n",
+        // many lower and upper bounds on the same variables
+        "(declare-const x Real) (declare-const y Real) (declare-const l1 Real) (declare-const l2 Real)\n"
+        "(declare-const u1 Real) (declare-const u2 Real)\n"
+        "(assert (<= l1 x)) (assert (<= l2 x)) (assert (<= (+ l1 l2) (* 2.0 y)))\n"
+        "(assert (<= x u1)) (assert (< x u2)) (assert (<= y (+ u1 u2)))\n"
+        "(assert (<= (+ x y) (+ u1 l2 5.0))) (assert (> (- u2 l1) 2.0))\n",
+    };
+
+    static app_ref mk_var(ast_manager& m, unsigned x) {
+        arith_util a(m);
+        std::ostringstream strm;
+        strm << "v" << x;
+        return app_ref(m.mk_const(symbol(strm.str().c_str()), a.mk_real()), m);
+    }
+
+    static void add_random_ineq(mbp_problem& p, random_gen& r, unsigned max_vars, unsigned max_coeff) {
+        ast_manager& m = p.m_lits.get_manager();
+        arith_util a(m);
+        unsigned num_vars = p.m_values.size();
+        uint_set used_vars;
+        vector<var_t> vars;
+        rational value(0);
+        for (unsigned i = 0; i < max_vars; ++i) {
+            unsigned x = r(num_vars);
+            if (used_vars.contains(x)) {
+                continue;
+            }
+            used_vars.insert(x);
+            int coeff = r(max_coeff + 1);
+            if (coeff == 0) {
+                continue;
+            }
+            coeff = r(2) == 0 ? coeff : -coeff;
+            vars.push_back(var_t(x, rational(coeff)));
+            value += rational(coeff) * p.m_values[x];
+        }
+        // value + k <= 0, value + k < 0 or value + k = 0 holds in the model.
+        opt::ineq_type rel = opt::t_le;
+        rational k;
+        if (r(4) == 0) {
+            rel = opt::t_eq;
+            k = -value;
+        }
+        else {
+            k = -value - rational(r(2 * abs(value).get_unsigned() + 1));
+            if (k != -value && r(3) == 0) {
+                rel = opt::t_lt;
+            }
+        }
+        expr_ref_vector ts(m);
+        for (var_t const& v : vars) {
+            ts.push_back(a.mk_mul(a.mk_numeral(v.m_coeff, false), p.m_vars.get(v.m_id)));
+        }
+        ts.push_back(a.mk_numeral(k, false));
+        expr_ref t(a.mk_add(ts.size(), ts.c_ptr()), m);
+        expr_ref zero(a.mk_numeral(rational(0), false), m);
+        switch (rel) {
+        case opt::t_eq: p.m_lits.push_back(m.mk_eq(t, zero)); break;
+        case opt::t_lt: p.m_lits.push_back(a.mk_lt(t, zero)); break;
+        default:        p.m_lits.push_back(a.mk_le(t, zero)); break;
+        }
+        p.m_rows.push_back(vars);
+        p.m_coeffs.push_back(k);
+        p.m_types.push_back(rel);
+    }
+
+    static void generate_problem(mbp_problem& p, random_gen& r, unsigned num_vars, unsigned num_ineqs, unsigned num_project) {
+        ast_manager& m = p.m_lits.get_manager();
+        arith_util a(m);
+        p.m_model = alloc(model, m);
+        p.m_has_rows = true;
+        for (unsigned i = 0; i < num_vars; ++i) {
+            p.m_values.push_back(rational(r(20)));
+            p.m_vars.push_back(mk_var(m, i));
+            p.m_model->register_decl(p.m_vars.back()->get_decl(), a.mk_numeral(p.m_values.back(), false));
+        }
+        for (unsigned i = 0; i < num_ineqs; ++i) {
+            add_random_ineq(p, r, 4, 5);
+        }
+        p.m_num_project = std::min(num_project, num_vars);
+    }
+
+    struct collect_arith_consts {
+        arith_util      m_arith;
+        app_ref_vector& m_consts;
+        obj_hashtable<app> m_seen;
+        collect_arith_consts(arith_util& a, app_ref_vector& cs): m_arith(a), m_consts(cs) {}
+        void operator()(var*) {}
+        void operator()(quantifier*) {}
+        void operator()(app* n) {
+            if (is_uninterp_const(n) && m_arith.is_int_real(n) && !m_seen.contains(n)) {
+                m_seen.insert(n);
+                m_consts.push_back(n);
+            }
+        }
+    };
+
+    static bool read_problem(mbp_problem& p, std::istream& in, char const* name) {
+        ast_manager& m = p.m_lits.get_manager();
+        arith_util a(m);
+        cmd_context ctx(false, &m);
+        ctx.set_ignore_check(true);
+        if (!parse_smt2_commands(ctx, in)) {
+            return false;
+        }
+        for (auto it = ctx.begin_assertions(); it != ctx.end_assertions(); ++it) {
+            flatten_and(*it, p.m_lits);
+        }
+        smt_params params;
+        params.m_model = true;
+        smt::kernel solver(m, params);
+        for (expr* e : p.m_lits) {
+            solver.assert_expr(e);
+        }
+        if (solver.check() != l_true) {
+            std::cerr << "(warning \"" << name << " is not satisfiable, skipped\")\n";
+            return false;
+        }
+        solver.get_model(p.m_model);
+        collect_arith_consts proc(a, p.m_vars);
+        expr_fast_mark1 visited;
+        for (expr* e : p.m_lits) {
+            quick_for_each_expr(proc, visited, e);
+        }
+        p.m_num_project = (p.m_vars.size() + 1) / 2;
+        return true;
+    }
+
+    static bool read_problem(mbp_problem& p, char const* file_name) {
+        std::ifstream in(file_name);
+        if (in.bad() || in.fail()) {
+            std::cerr << "(error \"failed to open file '" << file_name << "'\")\n";
+            return false;
+        }
+        return read_problem(p, in, file_name);
+    }
+
+    static unsigned size_of(expr_ref_vector const& lits) {
+        expr_fast_mark1 visited;
+        unsigned sz = 0;
+        for (expr* e : lits) {
+            sz += get_num_exprs(e, visited);
+        }
+        return sz;
+    }
+
+    static bool holds(model& mdl, expr_ref_vector const& lits) {
+        ast_manager& m = lits.get_manager();
+        expr_ref val(m);
+        for (expr* e : lits) {
+            if (!mdl.eval(e, val, true) || !m.is_true(val)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+       \brief return true if the conjunction of lits entails the projection of the
+       problem, that is, lits and (forall projected vars. not original) is unsatisfiable.
+    */
+    static bool entails_projection(mbp_problem const& p, expr_ref_vector const& lits) {
+        ast_manager& m = p.m_lits.get_manager();
+        app_ref_vector vars(m);
+        p.get_projected(vars);
+        goal_ref g = alloc(goal, m);
+        for (expr* e : lits) {
+            g->assert_expr(e);
+        }
+        g->assert_expr(mk_forall(m, vars.size(), vars.c_ptr(), m.mk_not(mk_and(p.m_lits))));
+        goal_ref_buffer result;
+        model_converter_ref mc;
+        proof_converter_ref pc;
+        expr_dependency_ref core(m);
+        tactic_ref t = mk_qsat_tactic(m);
+        try {
+            exec(*t, g, result, mc, pc, core);
+        }
+        catch (tactic_exception&) {
+            return false;
+        }
+        return result.size() == 1 && result[0]->is_decided_unsat();
+    }
+
+    /**
+       \brief return true if the conjunction of lits entails fml.
+    */
+    static bool entails(expr_ref_vector const& lits, expr* fml) {
+        ast_manager& m = lits.get_manager();
+        smt_params params;
+        smt::kernel solver(m, params);
+        for (expr* e : lits) {
+            solver.assert_expr(e);
+        }
+        solver.assert_expr(m.mk_not(fml));
+        return solver.check() == l_false;
+    }
+
+    /**
+       \brief a model based projection holds in the model and entails the projection.
+    */
+    static void check_mbp(mbp_problem const& p, model& mdl, expr_ref_vector const& lits, mbp_stats& st) {
+        if (!holds(mdl, lits) || !entails_projection(p, lits)) {
+            st.m_num_failed++;
+        }
+    }
+
+    /**
+       \brief a projection by elimination is implied by the original literals and,
+       if it eliminated all projected constants, entails the projection.
+    */
+    static void check_elim(mbp_problem const& p, expr_ref_vector const& lits, unsigned num_residual, mbp_stats& st) {
+        if (!entails(p.m_lits, mk_and(lits)) || (num_residual == 0 && !entails_projection(p, lits))) {
+            st.m_num_failed++;
+        }
+    }
+
+    static unsigned num_projected_in(mbp_problem const& p, expr_ref_vector const& lits) {
+        unsigned n = 0;
+        for (unsigned i = 0; i < p.m_num_project; ++i) {
+            expr* v = p.m_vars.get(i);
+            for (expr* e : lits) {
+                if (occurs(v, e)) {
+                    ++n;
+                    break;
+                }
+            }
+        }
+        return n;
+    }
+
+    static void run_mbo(mbp_problem const& p, mbp_stats& st) {
+        if (!p.m_has_rows) {
+            return;
+        }
+        opt::model_based_opt mbo;
+        for (rational const& v : p.m_values) {
+            mbo.add_var(v);
+        }
+        for (unsigned i = 0; i < p.m_rows.size(); ++i) {
+            mbo.add_constraint(p.m_rows[i], p.m_coeffs[i], p.m_types[i]);
+        }
+        unsigned_vector vars;
+        for (unsigned i = 0; i < p.m_num_project; ++i) {
+            vars.push_back(i);
+        }
+        vector<opt::model_based_opt::row> rows;
+        {
+            scoped_measure _sm(st);
+            mbo.project(vars.size(), vars.c_ptr());
+            mbo.get_live_rows(rows);
+        }
+        // translate the rows back to literals over the constants of the problem.
+        ast_manager& m = p.m_lits.get_manager();
+        arith_util a(m);
+        expr_ref_vector lits(m);
+        expr_ref zero(a.mk_numeral(rational(0), false), m);
+        for (auto const& r : rows) {
+            st.m_output_size += r.m_vars.size() + 1;
+            expr_ref_vector ts(m);
+            for (var_t const& v : r.m_vars) {
+                SASSERT(v.m_id < p.m_vars.size());
+                ts.push_back(a.mk_mul(a.mk_numeral(v.m_coeff, false), p.m_vars.get(v.m_id)));
+            }
+            ts.push_back(a.mk_numeral(r.m_coeff, false));
+            expr_ref t(a.mk_add(ts.size(), ts.c_ptr()), m);
+            switch (r.m_type) {
+            case opt::t_eq: lits.push_back(m.mk_eq(t, zero)); break;
+            case opt::t_lt: lits.push_back(a.mk_lt(t, zero)); break;
+            case opt::t_le: lits.push_back(a.mk_le(t, zero)); break;
+            default: UNREACHABLE(); break;
+            }
+        }
+        st.m_residual_vars += num_projected_in(p, lits);
+        check_mbp(p, *p.m_model.get(), lits, st);
+    }
+
+    static void run_arith(mbp_problem const& p, mbp_stats& st) {
+        ast_manager& m = p.m_lits.get_manager();
+        expr_ref_vector lits(p.m_lits);
+        app_ref_vector vars(m);
+        p.get_projected(vars);
+        model_ref mdl = p.m_model->copy();
+        {
+            scoped_measure _sm(st);
+            qe::arith_project_plugin plugin(m);
+            plugin(*mdl, vars, lits);
+        }
+        st.m_output_size += size_of(lits);
+        st.m_residual_vars += vars.size();
+        check_mbp(p, *mdl, lits, st);
+    }
+
+    static void run_mbp(mbp_problem const& p, mbp_stats& st) {
+        ast_manager& m = p.m_lits.get_manager();
+        expr_ref_vector lits(p.m_lits);
+        app_ref_vector vars(m);
+        p.get_projected(vars);
+        model_ref mdl = p.m_model->copy();
+        {
+            scoped_measure _sm(st);
+            qe::mbp mbp(m);
+            mbp(true, vars, *mdl, lits);
+        }
+        st.m_output_size += size_of(lits);
+        st.m_residual_vars += vars.size();
+        check_mbp(p, *mdl, lits, st);
+    }
+
+    static void run_spacer(mbp_problem const& p, mbp_stats& st) {
+        ast_manager& m = p.m_lits.get_manager();
+        app_ref_vector vars(m);
+        p.get_projected(vars);
+        model_ref mdl = p.m_model->copy();
+        expr_ref_vector lits(m);
+        {
+            scoped_measure _sm(st);
+            lits.push_back(qe::arith_project(*mdl, vars, p.m_lits));
+        }
+        st.m_output_size += size_of(lits);
+        st.m_residual_vars += vars.size();
+        check_mbp(p, *mdl, lits, st);
+    }
+
+    /**
+       The fm tactic eliminates every variable it can. The constants that
+       are not projected are protected by a literal over a fresh predicate,
+       which makes them occur outside of the linear constraints.
+    */
+    static void run_fm(mbp_problem const& p, mbp_stats& st) {
+        ast_manager& m = p.m_lits.get_manager();
+        arith_util a(m);
+        sort* real_sort = a.mk_real();
+        func_decl_ref keep(m.mk_fresh_func_decl("keep", 1, &real_sort, m.mk_bool_sort()), m);
+        goal_ref g = alloc(goal, m);
+        for (expr* e : p.m_lits) {
+            g->assert_expr(e);
+        }
+        for (unsigned i = p.m_num_project; i < p.m_vars.size(); ++i) {
+            expr* v = p.m_vars.get(i);
+            if (a.is_real(v)) {
+                g->assert_expr(m.mk_app(keep, v));
+            }
+        }
+        goal_ref_buffer result;
+        model_converter_ref mc;
+        proof_converter_ref pc;
+        expr_dependency_ref core(m);
+        {
+            scoped_measure _sm(st);
+            tactic_ref t = mk_fm_tactic(m);
+            exec(*t, g, result, mc, pc, core);
+        }
+        expr_ref_vector lits(m);
+        for (unsigned i = 0; i < result.size(); ++i) {
+            for (unsigned j = 0; j < result[i]->size(); ++j) {
+                expr* f = result[i]->form(j);
+                if (!is_app_of(f, keep)) {
+                    lits.push_back(f);
+                }
+            }
+        }
+        unsigned num_residual = num_projected_in(p, lits);
+        st.m_output_size += size_of(lits);
+        st.m_residual_vars += num_residual;
+        check_elim(p, lits, num_residual, st);
+    }
+
+    static bool parse_uint(char const* arg, char const* prefix, unsigned& value) {
+        size_t len = strlen(prefix);
+        if (strncmp(arg, prefix, len) == 0) {
+            value = atoi(arg + len);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+       \brief options of test-z3 that end the arguments of mbp_bench.
+       main has already cut option arguments at the ':'.
+    */
+    static bool is_test_option(char const* arg) {
+        if (arg[0] != '-' && arg[0] != '/') {
+            return false;
+        }
+        char const* name = arg + 1;
+        return
+            strcmp(name, "h") == 0 || strcmp(name, "?") == 0 || strcmp(name, "v") == 0 ||
+            strcmp(name, "w") == 0 || strcmp(name, "a") == 0 || strcmp(name, "tr") == 0 ||
+            strcmp(name, "dbg") == 0;
+    }
+
+    static bool check_baseline(mbp_stats const& st) {
+        for (mbp_baseline const& b : g_baseline) {
+            if (strcmp(b.m_name, st.m_name) != 0) {
+                continue;
+            }
+            bool ok = st.m_num_failed == 0 &&
+                10 * st.m_output_size <= 12 * b.m_output_size &&
+                10 * st.m_residual_vars <= 12 * b.m_residual_vars;
+            if (!ok) {
+                std::cout << "(mbp-bench :impl " << st.m_name << " :regression"
+                          << " :baseline-output-size " << b.m_output_size
+                          << " :baseline-residual-vars " << b.m_residual_vars << ")\n";
+            }
+            return ok;
+        }
+        return true;
+    }
+}
+
+void tst_mbp_bench(char ** argv, int argc, int& i) {
+    unsigned const default_seed = 0, default_count = 20, default_vars = 12, default_ineqs = 24, default_project = 6;
+    unsigned seed = default_seed, count = default_count, num_vars = default_vars, num_ineqs = default_ineqs, num_project = default_project;
+    ptr_vector<char const> files;
+    while (i + 1 < argc) {
+        char const* arg = argv[i + 1];
+        if (!parse_uint(arg, "seed:", seed) &&
+            !parse_uint(arg, "count:", count) &&
+            !parse_uint(arg, "vars:", num_vars) &&
+            !parse_uint(arg, "ineqs:", num_ineqs) &&
+            !parse_uint(arg, "project:", num_project)) {
+            if (is_test_option(arg)) {
+                break;
+            }
+            files.push_back(arg);
+        }
+        ++i;
+    }
+
+    ast_manager m;
+    reg_decl_plugins(m);
+    scoped_ptr_vector<mbp_problem> problems;
+    if (files.empty()) {
+        random_gen r(seed);
+        for (unsigned j = 0; j < count; ++j) {
+            mbp_problem* p = alloc(mbp_problem, m);
+            generate_problem(*p, r, num_vars, num_ineqs, num_project);
+            problems.push_back(p);
+        }
+        for (char const* spec : g_recorded) {
+            mbp_problem* p = alloc(mbp_problem, m);
+            std::istringstream in(spec);
+            if (read_problem(*p, in, "recorded problem")) {
+                problems.push_back(p);
+            }
+            else {
+                dealloc(p);
+            }
+        }
+    }
+    for (char const* f : files) {
+        mbp_problem* p = alloc(mbp_problem, m);
+        if (read_problem(*p, f)) {
+            problems.push_back(p);
+        }
+        else {
+            dealloc(p);
+        }
+    }
+
+    mbp_stats mbo("mbo"), arith("arith"), mbp("mbp"), spacer("spacer"), fm("fm");
+    for (unsigned j = 0; j < problems.size(); ++j) {
+        mbp_problem const& p = *problems[j];
+        run_mbo(p, mbo);
+        run_arith(p, arith);
+        run_mbp(p, mbp);
+        run_spacer(p, spacer);
+        run_fm(p, fm);
+    }
+    mbp_stats const* all[5] = { &mbo, &arith, &mbp, &spacer, &fm };
+    for (mbp_stats const* st : all) {
+        st->display(std::cout);
+    }
+
+    bool is_default =
+        files.empty() && seed == default_seed && count == default_count && num_vars == default_vars &&
+        num_ineqs == default_ineqs && num_project == default_project;
+    if (is_default) {
+        bool ok = true;
+        for (mbp_stats const* st : all) {
+            ok &= check_baseline(*st);
+        }
+        ENSURE(ok);
+    }
+}
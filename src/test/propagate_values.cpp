@@ -0,0 +1,82 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    propagate_values.cpp
+
+Abstract:
+
+    Test propagate-values on goals with independent components.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/ast_pp.h"
+#include "tactic/goal.h"
+#include "tactic/tactic.h"
+#include "tactic/goal_util.h"
+#include "tactic/core/propagate_values_tactic.h"
+
+static void apply(ast_manager & m, goal_ref const & g, obj_hashtable<expr> & result) {
+    tactic_ref t = mk_propagate_values_tactic(m);
+    goal_ref_buffer r;
+    model_converter_ref mc;
+    proof_converter_ref pc;
+    expr_dependency_ref core(m);
+    (*t)(g, r, mc, pc, core);
+    ENSURE(r.size() == 1);
+    for (unsigned i = 0; i < r[0]->size(); ++i)
+        result.insert(r[0]->form(i));
+}
+
+// Component i: x_i = i, x_i + y_i > 0, x_i + y_i < 100.
+// The last component has no unit and a formula the rewriter would simplify.
+static void tst1() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    unsigned num_comps = 30;
+    sort * I = a.mk_int();
+    expr_ref_vector fmls(m);
+    for (unsigned i = 0; i < num_comps; ++i) {
+        expr_ref x(m.mk_const(symbol((std::string("x") + std::to_string(i)).c_str()), I), m);
+        expr_ref y(m.mk_const(symbol((std::string("y") + std::to_string(i)).c_str()), I), m);
+        expr_ref s(a.mk_add(x, y), m);
+        fmls.push_back(m.mk_eq(x, a.mk_numeral(rational(i), true)));
+        fmls.push_back(a.mk_gt(s, a.mk_numeral(rational(0), true)));
+        fmls.push_back(a.mk_lt(s, a.mk_numeral(rational(100), true)));
+    }
+    expr_ref w(m.mk_const(symbol("w"), I), m);
+    expr_ref unsimplified(a.mk_gt(a.mk_add(w, a.mk_numeral(rational(0), true)), a.mk_numeral(rational(1), true)), m);
+    fmls.push_back(unsimplified);
+
+    goal_ref g = alloc(goal, m);
+    for (expr * f : fmls)
+        g->assert_expr(f);
+    unsigned_vector comp;
+    ENSURE(get_goal_components(*g, comp) == num_comps + 1);
+
+    // propagate-values on the whole goal gives the same formulas as on every
+    // component by itself.
+    obj_hashtable<expr> whole, parts;
+    apply(m, g, whole);
+    for (unsigned c = 0; c <= num_comps; ++c) {
+        goal_ref gc = alloc(goal, m);
+        for (unsigned i = 0; i < fmls.size(); ++i)
+            if (comp[i] == c)
+                gc->assert_expr(fmls.get(i));
+        apply(m, gc, parts);
+    }
+    ENSURE(whole.size() == parts.size());
+    for (expr * e : whole) {
+        CTRACE("propagate_values", !parts.contains(e), tout << mk_pp(e, m) << "\n";);
+        ENSURE(parts.contains(e));
+    }
+    // the component without substitution entries is not rewritten.
+    ENSURE(whole.contains(unsimplified));
+}
+
+void tst_propagate_values() {
+    tst1();
+}
@@ -0,0 +1,54 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    select_max.cpp
+
+Abstract:
+
+    Test the select-max tactical with linear scores over goal features.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "tactic/goal.h"
+#include "tactic/tactical.h"
+#include "tactic/probe.h"
+
+// run select-max on a goal with num_consts Boolean constants,
+// return true if the skip tactic was selected.
+static bool selects_skip(unsigned num_consts) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    goal_ref g = alloc(goal, m);
+    for (unsigned i = 0; i < num_consts; ++i)
+        g->assert_expr(m.mk_const(symbol((std::string("p") + std::to_string(i)).c_str()), m.mk_bool_sort()));
+    // skip scores 10.5 - num-bool-consts, fail scores 1.5 * num-bool-consts.
+    probe_ref n = mk_num_bool_consts_probe();
+    probe_ref skip_score = mk_sub(mk_const_probe(10.5), n.get());
+    probe_ref fail_score = mk_mul(mk_const_probe(1.5), n.get());
+    probe * scores[2] = { skip_score.get(), fail_score.get() };
+    tactic_ref skip = mk_skip_tactic();
+    tactic_ref fail = mk_fail_tactic();
+    tactic * ts[2] = { skip.get(), fail.get() };
+    tactic_ref t = select_max(2, scores, ts);
+    goal_ref_buffer r;
+    model_converter_ref mc;
+    proof_converter_ref pc;
+    expr_dependency_ref core(m);
+    try {
+        (*t)(g, r, mc, pc, core);
+        ENSURE(r.size() == 1 && r[0]->size() == num_consts);
+        return true;
+    }
+    catch (tactic_exception &) {
+        return false;
+    }
+}
+
+void tst_select_max() {
+    ENSURE(selects_skip(0));
+    ENSURE(selects_skip(4));
+    ENSURE(!selects_skip(5));
+    ENSURE(!selects_skip(20));
+}
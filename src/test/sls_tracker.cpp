@@ -0,0 +1,200 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    sls_tracker.cpp
+
+Abstract:
+
+    Test the incrementally tracked unsat assertions and unsat constants
+    of the SLS tracker (sls.track_unsat) against a rescan of the assertions,
+    in walksat and in gsat mode.
+
+--*/
+#include "tactic/sls/sls_engine.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/expr_substitution.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+
+// runs the moves of sls_engine::search and checks the tracked state after each of them.
+class sls_tracker_tester : public sls_engine {
+public:
+    sls_tracker_tester(ast_manager & m, params_ref const & p): sls_engine(m, p) {}
+
+    void check() {
+        ENSURE(m_tracker.check_unsat_tracking(m_assertions));
+    }
+
+    bool run(unsigned max_moves) {
+        m_tracker.initialize(m_assertions);
+        check();
+        m_tracker.randomize(m_assertions);
+        double score = rescore();
+        check();
+        bool sat = false;
+        mpz new_value;
+        for (unsigned i = 0; !sat && i < max_moves; ++i) {
+            ptr_vector<func_decl> & to_evaluate = m_tracker.get_unsat_constants(m_assertions);
+            if (to_evaluate.empty()) {
+                ENSURE(m_tracker.is_sat());
+                sat = true;
+                break;
+            }
+            unsigned new_const = UINT_MAX, new_bit = 0;
+            move_type move;
+            if (m_tracker.get_random_uint(3) == 0) {
+                mk_random_move(to_evaluate);
+                score = m_tracker.get_top_sum();
+            }
+            else {
+                find_best_move(to_evaluate, score, new_const, new_value, new_bit, move);
+                if (new_const == UINT_MAX) {
+                    if (m_walksat)
+                        m_evaluator.randomize_local(m_assertions);
+                    else
+                        m_evaluator.randomize_local(to_evaluate);
+                    score = m_tracker.get_top_sum();
+                }
+                else
+                    score = serious_score(to_evaluate[new_const], new_value);
+            }
+            check();
+        }
+        m_mpz_manager.del(new_value);
+        return sat;
+    }
+};
+
+static void mk_constants(ast_manager & m, unsigned num, unsigned bv_sz, app_ref_vector & xs) {
+    bv_util bv(m);
+    for (unsigned i = 0; i < num; ++i) {
+        std::string name = "x" + std::to_string(i);
+        xs.push_back(m.mk_const(symbol(name.c_str()), bv.mk_sort(bv_sz)));
+    }
+}
+
+// a term over xs, or a numeral if is_ground. The engine does not evaluate ground
+// subterms (the sls tactic simplifies them away), so only leaves can be ground.
+static expr_ref mk_term(ast_manager & m, random_gen & r, app_ref_vector const & xs, unsigned depth, bool is_ground) {
+    bv_util bv(m);
+    unsigned bv_sz = bv.get_bv_size(xs.get(0));
+    if (is_ground)
+        return expr_ref(bv.mk_numeral(rational(r(1 << bv_sz)), bv_sz), m);
+    if (depth == 0 || r(3) == 0)
+        return expr_ref(xs.get(r(xs.size())), m);
+    expr_ref a = mk_term(m, r, xs, depth - 1, false);
+    expr_ref b = mk_term(m, r, xs, depth - 1, r(4) == 0);
+    switch (r(5)) {
+    case 0:  return expr_ref(bv.mk_bv_add(a, b), m);
+    case 1:  return expr_ref(bv.mk_bv_mul(a, b), m);
+    case 2:  return expr_ref(m.mk_app(bv.get_fid(), OP_BXOR, a, b), m);
+    case 3:  return expr_ref(m.mk_app(bv.get_fid(), OP_BAND, a, b), m);
+    default: return expr_ref(bv.mk_bv_not(a), m);
+    }
+}
+
+// an atom over xs that rw evaluates to is_true, negated if necessary.
+static expr_ref mk_literal(ast_manager & m, random_gen & r, app_ref_vector const & xs, th_rewriter & rw, bool is_true) {
+    bv_util bv(m);
+    expr_ref t = mk_term(m, r, xs, 2, false);
+    expr_ref s = mk_term(m, r, xs, 2, r(4) == 0);
+    expr_ref a(m), v(m);
+    switch (r(3)) {
+    case 0:  a = m.mk_eq(t, s); break;
+    case 1:  a = bv.mk_ule(t, s); break;
+    default: a = bv.mk_sle(t, s); break;
+    }
+    rw(a, v);
+    ENSURE(m.is_true(v) || m.is_false(v));
+    if (m.is_true(v) != is_true)
+        a = m.mk_not(a);
+    return a;
+}
+
+// assertions that hold for a random assignment to xs.
+static void mk_goal(ast_manager & m, random_gen & r, app_ref_vector const & xs, unsigned num, expr_ref_vector & fmls) {
+    bv_util bv(m);
+    unsigned bv_sz = bv.get_bv_size(xs.get(0));
+    expr_substitution sub(m);
+    for (app * x : xs)
+        sub.insert(x, bv.mk_numeral(rational(r(1 << bv_sz)), bv_sz));
+    th_rewriter rw(m);
+    rw.set_substitution(&sub);
+    for (unsigned i = 0; i < num; ++i) {
+        expr_ref f = mk_literal(m, r, xs, rw, true);
+        if (r(3) == 0)
+            f = m.mk_or(mk_literal(m, r, xs, rw, r(2) == 0), f);
+        fmls.push_back(f);
+    }
+}
+
+static params_ref mk_params(bool walksat, unsigned seed) {
+    params_ref p;
+    p.set_bool("walksat", walksat);
+    p.set_bool("walksat_repick", walksat);
+    p.set_bool("track_unsat", true);
+    p.set_uint("random_seed", seed);
+    return p;
+}
+
+static void tst_tracking(bool walksat) {
+    random_gen r(walksat ? 0 : 1);
+    unsigned num_sat = 0;
+    for (unsigned i = 0; i < 40; ++i) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        app_ref_vector xs(m);
+        mk_constants(m, 2 + r(4), 8, xs);
+        expr_ref_vector fmls(m);
+        mk_goal(m, r, xs, 5 + r(20), fmls);
+        TRACE("sls_tracker", for (expr * f : fmls) tout << mk_pp(f, m) << "\n";);
+        sls_tracker_tester t(m, mk_params(walksat, i));
+        for (expr * f : fmls)
+            t.assert_expr(f);
+        if (t.run(2000))
+            num_sat++;
+    }
+    std::cout << (walksat ? "walksat" : "gsat") << ": " << num_sat << " of 40 solved\n";
+}
+
+// the models found by the engine satisfy the goal, in both modes.
+static void tst_engine(bool walksat) {
+    random_gen r(walksat ? 2 : 3);
+    unsigned num_sat = 0;
+    for (unsigned i = 0; i < 10; ++i) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        app_ref_vector xs(m);
+        mk_constants(m, 3, 8, xs);
+        expr_ref_vector fmls(m);
+        mk_goal(m, r, xs, 12, fmls);
+        goal_ref g = alloc(goal, m);
+        for (expr * f : fmls)
+            g->assert_expr(f);
+        params_ref p = mk_params(walksat, i);
+        p.set_uint("max_restarts", 10);
+        sls_engine e(m, p);
+        model_converter_ref mc;
+        e(g, mc);
+        if (!g->is_decided_sat())
+            continue;
+        num_sat++;
+        model_ref mdl;
+        (*mc)(mdl, 0);
+        for (expr * f : fmls) {
+            expr_ref v(m);
+            ENSURE(mdl->eval(f, v, true) && m.is_true(v));
+        }
+    }
+    std::cout << (walksat ? "walksat" : "gsat") << " engine: " << num_sat << " of 10 solved\n";
+    ENSURE(num_sat > 0);
+}
+
+void tst_sls_tracker() {
+    tst_tracking(true);
+    tst_tracking(false);
+    tst_engine(true);
+    tst_engine(false);
+}
@@ -0,0 +1,153 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    smt2_scanner.cpp
+
+Abstract:
+
+    Test the numeral and bit-vector literals of the SMT2 scanner,
+    in particular literals that do not fit in a machine word.
+
+--*/
+#include<sstream>
+#include "parsers/smt2/smt2scanner.h"
+#include "cmd_context/cmd_context.h"
+#include "util/util.h"
+
+static std::string random_digits(random_gen & r, unsigned len, unsigned base) {
+    static char const digits[] = "0123456789abcdef";
+    std::string s;
+    for (unsigned i = 0; i < len; ++i)
+        s.push_back(digits[r(base)]);
+    return s;
+}
+
+static rational digits2rational(std::string const & s, unsigned base) {
+    rational r(0);
+    for (char c : s) {
+        unsigned d = ('0' <= c && c <= '9') ? c - '0' : c - 'a' + 10;
+        r = r * rational(base) + rational(d);
+    }
+    return r;
+}
+
+struct expected_token {
+    smt2::scanner::token m_kind;
+    rational             m_value;
+    unsigned             m_bv_size;
+    expected_token(smt2::scanner::token k, rational const & v, unsigned sz = 0):
+        m_kind(k), m_value(v), m_bv_size(sz) {}
+};
+
+static void check(std::string const & input, vector<expected_token> const & expected) {
+    cmd_context ctx;
+    std::istringstream in(input);
+    smt2::scanner s(ctx, in);
+    for (expected_token const & e : expected) {
+        smt2::scanner::token t = s.scan();
+        CTRACE("smt2_scanner", t != e.m_kind, tout << t << " expected " << e.m_kind << "\n";);
+        ENSURE(t == e.m_kind);
+        if (t == smt2::scanner::INT_TOKEN || t == smt2::scanner::FLOAT_TOKEN || t == smt2::scanner::BV_TOKEN) {
+            CTRACE("smt2_scanner", s.get_number() != e.m_value, tout << s.get_number() << " expected " << e.m_value << "\n";);
+            ENSURE(s.get_number() == e.m_value);
+        }
+        if (t == smt2::scanner::BV_TOKEN)
+            ENSURE(s.get_bv_size() == e.m_bv_size);
+    }
+    ENSURE(s.scan() == smt2::scanner::EOF_TOKEN);
+}
+
+// decimals around and beyond the 18 digits collected in one word.
+static void tst_numerals() {
+    random_gen r(0);
+    for (unsigned len = 1; len <= 80; ++len) {
+        std::string d = random_digits(r, len, 10);
+        vector<expected_token> e;
+        e.push_back(expected_token(smt2::scanner::INT_TOKEN, digits2rational(d, 10)));
+        check(d, e);
+        // leading zeros
+        std::string z = std::string(len, '0') + d;
+        check(z + " ", e);
+    }
+    vector<expected_token> e;
+    e.push_back(expected_token(smt2::scanner::INT_TOKEN, rational("999999999999999999")));
+    e.push_back(expected_token(smt2::scanner::INT_TOKEN, rational("1000000000000000000")));
+    e.push_back(expected_token(smt2::scanner::INT_TOKEN, rational("18446744073709551615")));
+    e.push_back(expected_token(smt2::scanner::INT_TOKEN, rational("18446744073709551616")));
+    check("999999999999999999 1000000000000000000 18446744073709551615 18446744073709551616", e);
+}
+
+// decimals with long integer and fractional parts.
+static void tst_decimals() {
+    random_gen r(1);
+    for (unsigned len1 = 1; len1 <= 40; len1 += 3) {
+        for (unsigned len2 = 1; len2 <= 60; len2 += 7) {
+            std::string i = random_digits(r, len1, 10);
+            std::string f = random_digits(r, len2, 10);
+            rational v = digits2rational(i + f, 10) / power(rational(10), len2);
+            vector<expected_token> e;
+            e.push_back(expected_token(smt2::scanner::FLOAT_TOKEN, v));
+            check(i + "." + f, e);
+            e.reset();
+            e.push_back(expected_token(smt2::scanner::LEFT_PAREN, rational(0)));
+            e.push_back(expected_token(smt2::scanner::FLOAT_TOKEN, v));
+            e.push_back(expected_token(smt2::scanner::RIGHT_PAREN, rational(0)));
+            check("(" + i + "." + f + ")", e);
+        }
+    }
+}
+
+// hexadecimal and binary literals around and beyond 64 bits.
+static void tst_bv_literals() {
+    random_gen r(2);
+    for (unsigned len = 1; len <= 40; ++len) {
+        std::string h = random_digits(r, len, 16);
+        vector<expected_token> e;
+        e.push_back(expected_token(smt2::scanner::BV_TOKEN, digits2rational(h, 16), 4 * len));
+        check("#x" + h, e);
+        std::string upper(h);
+        for (char & c : upper)
+            c = toupper(c);
+        check("#x" + upper + "\n", e);
+    }
+    for (unsigned len = 1; len <= 150; ++len) {
+        std::string b = random_digits(r, len, 2);
+        vector<expected_token> e;
+        e.push_back(expected_token(smt2::scanner::BV_TOKEN, digits2rational(b, 2), len));
+        check("#b" + b, e);
+    }
+}
+
+// literals that cross the end of the scanner's read buffer.
+static void tst_buffer_boundary() {
+    random_gen r(3);
+    std::string d = random_digits(r, 40, 10);
+    std::string h = random_digits(r, 40, 16);
+    std::string b = random_digits(r, 100, 2);
+    std::string f = random_digits(r, 30, 10);
+    rational vf = digits2rational(d + f, 10) / power(rational(10), 30);
+    for (unsigned shift = 0; shift < 120; shift += 7) {
+        std::string pad((1 << 16) - shift, ' ');
+        vector<expected_token> e;
+        e.push_back(expected_token(smt2::scanner::INT_TOKEN, digits2rational(d, 10)));
+        check(pad + d, e);
+        e.reset();
+        e.push_back(expected_token(smt2::scanner::FLOAT_TOKEN, vf));
+        check(pad + d + "." + f, e);
+        e.reset();
+        e.push_back(expected_token(smt2::scanner::BV_TOKEN, digits2rational(h, 16), 160));
+        check(pad + "#x" + h, e);
+        e.reset();
+        e.push_back(expected_token(smt2::scanner::BV_TOKEN, digits2rational(b, 2), 100));
+        check(pad + "#b" + b, e);
+    }
+}
+
+void tst_smt2_scanner() {
+    tst_numerals();
+    tst_decimals();
+    tst_bv_literals();
+    tst_buffer_boundary();
+}
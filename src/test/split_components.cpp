@@ -0,0 +1,109 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    split_components.cpp
+
+Abstract:
+
+    Test the split-components combinator.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/ast_pp.h"
+#include "model/model.h"
+#include "tactic/goal.h"
+#include "tactic/goal_util.h"
+#include "tactic/tactical.h"
+#include "tactic/core/solve_eqs_tactic.h"
+#include "smt/tactic/smt_tactic.h"
+
+static expr_ref mk_int(ast_manager & m, char const * name) {
+    arith_util a(m);
+    return expr_ref(m.mk_const(symbol(name), a.mk_int()), m);
+}
+
+static void apply(goal_ref const & g, goal_ref_buffer & r, model_converter_ref & mc) {
+    ast_manager & m = g->m();
+    tactic_ref t = split_components(and_then(mk_solve_eqs_tactic(m), mk_smt_tactic()));
+    proof_converter_ref pc;
+    expr_dependency_ref core(m);
+    (*t)(g, r, mc, pc, core);
+}
+
+// x = y + 1, y > 3; u = v, v < 0; f(z) > z
+static void tst_sat() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x = mk_int(m, "x"), y = mk_int(m, "y"), u = mk_int(m, "u"), v = mk_int(m, "v"), z = mk_int(m, "z");
+    func_decl_ref f(m.mk_func_decl(symbol("f"), a.mk_int(), a.mk_int()), m);
+    expr_ref_vector fmls(m);
+    fmls.push_back(m.mk_eq(x, a.mk_add(y, a.mk_numeral(rational(1), true))));
+    fmls.push_back(a.mk_gt(y, a.mk_numeral(rational(3), true)));
+    fmls.push_back(m.mk_eq(u, v));
+    fmls.push_back(a.mk_lt(v, a.mk_numeral(rational(0), true)));
+    fmls.push_back(a.mk_gt(m.mk_app(f, z.get()), z));
+    goal_ref g = alloc(goal, m);
+    for (expr * e : fmls)
+        g->assert_expr(e);
+    goal_ref_buffer r;
+    model_converter_ref mc;
+    apply(g, r, mc);
+    ENSURE(is_decided_sat(r));
+    ENSURE(mc);
+    // the model merged from all components satisfies every formula.
+    model_ref md = alloc(model, m);
+    (*mc)(md, 0);
+    for (expr * e : fmls) {
+        expr_ref val(m);
+        ENSURE(md->eval(e, val, true));
+        CTRACE("split_components", !m.is_true(val), tout << mk_pp(e, m) << " -> " << val << "\n";);
+        ENSURE(m.is_true(val));
+    }
+}
+
+// The second component is unsat, so the goal is.
+static void tst_unsat() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x = mk_int(m, "x"), y = mk_int(m, "y");
+    goal_ref g = alloc(goal, m);
+    g->assert_expr(a.mk_gt(x, a.mk_numeral(rational(3), true)));
+    g->assert_expr(a.mk_gt(y, a.mk_numeral(rational(3), true)));
+    g->assert_expr(a.mk_lt(y, a.mk_numeral(rational(2), true)));
+    goal_ref_buffer r;
+    model_converter_ref mc;
+    apply(g, r, mc);
+    ENSURE(is_decided_unsat(r));
+}
+
+// forall x, y : U. x = y; a != b
+// The formulas share no symbol, but both constrain the universe of U.
+static void tst_uninterpreted_sort() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    sort_ref u(m.mk_uninterpreted_sort(symbol("U")), m);
+    expr_ref a(m.mk_const(symbol("a"), u), m), b(m.mk_const(symbol("b"), u), m);
+    sort * sorts[2] = { u, u };
+    symbol names[2] = { symbol("x"), symbol("y") };
+    expr_ref body(m.mk_eq(m.mk_var(0, u), m.mk_var(1, u)), m);
+    goal_ref g = alloc(goal, m);
+    g->assert_expr(m.mk_forall(2, sorts, names, body));
+    g->assert_expr(m.mk_not(m.mk_eq(a, b)));
+    unsigned_vector comp;
+    ENSURE(get_goal_components(*g, comp) == 1);
+    goal_ref_buffer r;
+    model_converter_ref mc;
+    apply(g, r, mc);
+    ENSURE(is_decided_unsat(r));
+}
+
+void tst_split_components() {
+    tst_sat();
+    tst_unsat();
+    tst_uninterpreted_sort();
+}
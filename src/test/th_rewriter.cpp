@@ -0,0 +1,174 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    th_rewriter.cpp
+
+Abstract:
+
+    Test the persistent cache of th_rewriter (rewriter.persistent_cache).
+
+--*/
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/expr_substitution.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include "util/statistics.h"
+
+static unsigned get_stat(th_rewriter const & rw, char const * key) {
+    statistics st;
+    rw.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+// formulas over x, y with shared subterms that the rewriter simplifies.
+static void mk_formulas(ast_manager & m, expr_ref_vector & fmls) {
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref y(m.mk_const(symbol("y"), a.mk_int()), m);
+    expr_ref one(a.mk_numeral(rational(1), true), m);
+    expr_ref zero(a.mk_numeral(rational(0), true), m);
+    expr_ref s(a.mk_add(x, a.mk_mul(zero, y), one), m);
+    expr_ref t(a.mk_add(s, s, y), m);
+    fmls.push_back(a.mk_le(t, a.mk_add(x, one)));
+    fmls.push_back(m.mk_or(a.mk_ge(s, zero), m.mk_not(a.mk_le(t, s))));
+    fmls.push_back(m.mk_and(m.mk_eq(s, t), m.mk_iff(a.mk_le(t, s), a.mk_ge(x, one))));
+    fmls.push_back(m.mk_ite(a.mk_le(x, y), m.mk_eq(t, zero), a.mk_lt(s, t)));
+}
+
+static void rewrite(th_rewriter & rw, expr_ref_vector const & fmls, expr_ref_vector & result) {
+    result.reset();
+    for (expr * f : fmls) {
+        expr_ref r(result.get_manager());
+        rw(f, r);
+        result.push_back(r);
+    }
+}
+
+static void ensure_same(expr_ref_vector const & r1, expr_ref_vector const & r2) {
+    ENSURE(r1.size() == r2.size());
+    for (unsigned i = 0; i < r1.size(); ++i) {
+        CTRACE("th_rewriter", r1.get(i) != r2.get(i), tout << mk_pp(r1.get(i), r1.get_manager()) << "\n" << mk_pp(r2.get(i), r2.get_manager()) << "\n";);
+        ENSURE(r1.get(i) == r2.get(i));
+    }
+}
+
+// results with the cache are the results without it, also after updt_params and cleanup.
+static void tst_results() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector fmls(m), expected(m), r(m);
+    mk_formulas(m, fmls);
+
+    params_ref p;
+    th_rewriter plain(m, p);
+    rewrite(plain, fmls, expected);
+
+    params_ref pc;
+    pc.set_uint("persistent_cache", 1000);
+    th_rewriter rw(m, pc);
+    rewrite(rw, fmls, r);
+    ensure_same(expected, r);
+    ENSURE(get_stat(rw, "rewriter cache size") > 0);
+
+    // the second round is answered from the cache.
+    unsigned hits = get_stat(rw, "rewriter cache hits");
+    rw.reset();
+    rewrite(rw, fmls, r);
+    ensure_same(expected, r);
+    ENSURE(get_stat(rw, "rewriter cache hits") >= hits + fmls.size());
+
+    // the cache survives cleanup.
+    rw.cleanup();
+    ENSURE(get_stat(rw, "rewriter cache size") > 0);
+    hits = get_stat(rw, "rewriter cache hits");
+    rewrite(rw, fmls, r);
+    ensure_same(expected, r);
+    ENSURE(get_stat(rw, "rewriter cache hits") >= hits + fmls.size());
+
+    // a different configuration flushes the cache, and gives the results of
+    // a rewriter created with that configuration.
+    params_ref p2(pc);
+    p2.set_bool("arith_lhs", true);
+    p2.set_bool("som", true);
+    th_rewriter plain2(m, p2);
+    expr_ref_vector expected2(m);
+    rewrite(plain2, fmls, expected2);
+    rw.updt_params(p2);
+    ENSURE(get_stat(rw, "rewriter cache size") == 0);
+    rewrite(rw, fmls, r);
+    ensure_same(expected2, r);
+
+    // and back.
+    rw.updt_params(pc);
+    ENSURE(get_stat(rw, "rewriter cache size") == 0);
+    rewrite(rw, fmls, r);
+    ensure_same(expected, r);
+}
+
+// a substitution bypasses the cache: the cached results without it are not used.
+static void tst_substitution() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref_vector fmls(m), r(m), expected(m);
+    mk_formulas(m, fmls);
+
+    params_ref pc;
+    pc.set_uint("persistent_cache", 1000);
+    th_rewriter rw(m, pc);
+    rewrite(rw, fmls, r);
+    unsigned hits = get_stat(rw, "rewriter cache hits");
+    unsigned size = get_stat(rw, "rewriter cache size");
+
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_substitution sub(m);
+    sub.insert(x, a.mk_numeral(rational(3), true));
+
+    th_rewriter plain(m);
+    plain.set_substitution(&sub);
+    rewrite(plain, fmls, expected);
+
+    rw.set_substitution(&sub);
+    rewrite(rw, fmls, r);
+    ensure_same(expected, r);
+    ENSURE(get_stat(rw, "rewriter cache hits") == hits);
+    ENSURE(get_stat(rw, "rewriter cache size") == size);
+    rw.set_substitution(nullptr);
+}
+
+// proof generation bypasses the cache.
+static void tst_proofs() {
+    ast_manager m(PGM_ENABLED);
+    reg_decl_plugins(m);
+    expr_ref_vector fmls(m), r(m), expected(m);
+    mk_formulas(m, fmls);
+
+    th_rewriter plain(m);
+    rewrite(plain, fmls, expected);
+
+    params_ref pc;
+    pc.set_uint("persistent_cache", 1000);
+    th_rewriter rw(m, pc);
+    for (expr * f : fmls) {
+        expr_ref res(m);
+        proof_ref pr(m);
+        rw(f, res, pr);
+        r.push_back(res);
+    }
+    ensure_same(expected, r);
+    ENSURE(get_stat(rw, "rewriter cache size") == 0);
+    ENSURE(get_stat(rw, "rewriter cache hits") == 0);
+    ENSURE(get_stat(rw, "rewriter cache misses") == 0);
+}
+
+void tst_th_rewriter() {
+    tst_results();
+    tst_substitution();
+    tst_proofs();
+}
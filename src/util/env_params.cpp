@@ -21,6 +21,7 @@ Notes:
 #include "util/gparams.h"
 #include "util/util.h"
 #include "util/memory_manager.h"
+#include "util/z3_omp.h"
 
 void env_params::updt_params() {
     params_ref p = gparams::get();
@@ -29,6 +30,9 @@ void env_params::updt_params() {
     memory::set_max_size(megabytes_to_bytes(p.get_uint("memory_max_size", 0)));
     memory::set_max_alloc_count(p.get_uint("memory_max_alloc_count", 0));
     memory::set_high_watermark(p.get_uint("memory_high_watermark", 0));
+    memory::set_profile(p.get_bool("memory_profile", false));
+    memory::set_profile_dump_step(megabytes_to_bytes(p.get_uint("memory_profile_step", 0)));
+    set_max_omp_threads(p.get_uint("threads_max", 0));
 }
 
 void env_params::collect_param_descrs(param_descrs & d) {
@@ -37,4 +41,7 @@ void env_params::collect_param_descrs(param_descrs & d) {
     d.insert("memory_max_size", CPK_UINT, "set hard upper limit for memory consumption (in megabytes), if 0 then there is no limit", "0");
     d.insert("memory_max_alloc_count", CPK_UINT, "set hard upper limit for memory allocations, if 0 then there is no limit", "0");
     d.insert("memory_high_watermark", CPK_UINT, "set high watermark for memory consumption (in megabytes), if 0 then there is no limit", "0");
+    d.insert("memory_profile", CPK_BOOL, "attribute allocations to subsystems and report them in the statistics", "false");
+    d.insert("memory_profile_step", CPK_UINT, "with memory_profile, print the profile as JSON to stderr whenever the profiled memory grew by this amount (in megabytes), if 0 then the profile is not printed", "0");
+    d.insert("threads_max", CPK_UINT, "maximal number of threads used at the same time by parallel tactics and the parallel SAT solver, if 0 then there is no limit", "0");
 }
@@ -290,6 +290,8 @@ public:
     bool diagonal_element_is_off(T /* diag_element */) { return false; }
 
     void pivot_and_solve_the_system(unsigned replaced_column, unsigned lowest_row_of_the_bump);
+
+    void compact_row_eta_work_vector_index();
     // see Achim Koberstein's thesis page 58, but here we solve the system and pivot to the last
     // row at the same time
     row_eta_matrix<T, X> *get_row_eta_matrix_and_set_row_vector(unsigned replaced_column, unsigned lowest_row_of_the_bump, const T &  pivot_elem_for_checking);
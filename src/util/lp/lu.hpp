@@ -808,9 +808,14 @@ void lu<T, X>::scan_last_row_to_work_vector(unsigned lowest_row_of_the_bump) {
 template <typename T, typename X>
 void lu<T, X>::pivot_and_solve_the_system(unsigned replaced_column, unsigned lowest_row_of_the_bump) {
     // we have the system right side at m_row_eta_work_vector now
-    // solve the system column wise
+    // solve the system column wise.
+    // Entries that drop below the tolerance are zeroed but left in m_index:
+    // erasing them one by one makes the bump elimination quadratic in the
+    // row length. The index is compacted once at the end instead.
+    indexed_vector<T> & w = m_row_eta_work_vector;
+    bool has_stale_index = false;
     for (unsigned j = replaced_column; j < lowest_row_of_the_bump; j++) {
-        T v = m_row_eta_work_vector[j];
+        T v = w[j];
         if (numeric_traits<T>::is_zero(v)) continue; // this column does not contribute to the solution
         unsigned aj = m_U.adjust_row(j);
         vector<indexed_value<T>> & row = m_U.get_row_values(aj);
@@ -827,22 +832,37 @@ void lu<T, X>::pivot_and_solve_the_system(unsigned replaced_column, unsigned low
 
 
             
-           // m_row_eta_work_vector.add_value_at_index_with_drop_tolerance(col, delta);
-            if (numeric_traits<T>::is_zero(m_row_eta_work_vector[col])) {
+            T & wc = w[col];
+            if (numeric_traits<T>::is_zero(wc)) {
                 if (!m_settings.abs_val_is_smaller_than_drop_tolerance(delta)){
-                    m_row_eta_work_vector.set_value(delta, col);
+                    wc = delta;
+                    w.m_index.push_back(col);
                 }
             } else {
-                T t = (m_row_eta_work_vector[col] += delta);
-                if (m_settings.abs_val_is_smaller_than_drop_tolerance(t)){
-                    m_row_eta_work_vector[col] = numeric_traits<T>::zero();
-                    auto it = std::find(m_row_eta_work_vector.m_index.begin(), m_row_eta_work_vector.m_index.end(), col);
-                    if (it != m_row_eta_work_vector.m_index.end())
-                        m_row_eta_work_vector.m_index.erase(it);
-                }
+                wc += delta;
+                if (m_settings.abs_val_is_smaller_than_drop_tolerance(wc)){
+                    wc = numeric_traits<T>::zero();
+                    has_stale_index = true;
                 }
+            }
         }
     }
+    if (has_stale_index)
+        compact_row_eta_work_vector_index();
+}
+
+// removes the zero entries and the duplicates from m_row_eta_work_vector.m_index
+template <typename T, typename X>
+void lu<T, X>::compact_row_eta_work_vector_index() {
+    vector<unsigned> & index = m_row_eta_work_vector.m_index;
+    unsigned k = 0;
+    for (unsigned j : index) {
+        if (!numeric_traits<T>::is_zero(m_row_eta_work_vector[j]))
+            index[k++] = j;
+    }
+    index.shrink(k);
+    std::sort(index.begin(), index.end());
+    index.shrink(static_cast<unsigned>(std::unique(index.begin(), index.end()) - index.begin()));
 }
 // see Achim Koberstein's thesis page 58, but here we solve the system and pivot to the last
 // row at the same time
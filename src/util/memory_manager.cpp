@@ -7,10 +7,15 @@ Copyright (c) 2015 Microsoft Corporation
 #include<iostream>
 #include<stdlib.h>
 #include<limits.h>
+#include<string.h>
+#include<stdio.h>
 #include "util/trace.h"
 #include "util/memory_manager.h"
 #include "util/error_codes.h"
+#include "util/warning.h"
+#include "util/statistics.h"
 #include "util/z3_omp.h"
+#include "util/rlimit.h"
 // The following two function are automatically generated by the mk_make.py script.
 // The script collects ADD_INITIALIZER and ADD_FINALIZER commands in the .h files.
 // For example, rational.h contains
@@ -52,11 +57,216 @@ void memory::exit_when_out_of_memory(bool flag, char const * msg) {
         g_out_of_memory_msg = msg;
 }
 
+// ==================================
+// Allocation profiler
+// ==================================
+
+#if defined(_WINDOWS)
+__declspec(thread) unsigned g_memory_thread_tag = 0;
+#elif defined(_USE_THREAD_LOCAL)
+__thread unsigned g_memory_thread_tag = 0;
+#else
+static unsigned g_memory_thread_tag = 0;
+#endif
+
+#define MAX_MEMORY_TAGS 255
+#define MEMORY_TAG_KEY_SIZE 64
+
+struct memory_tag_stats {
+    char const * m_name;
+    long long    m_live;
+    long long    m_peak;
+    long long    m_count;
+    char         m_live_key[MEMORY_TAG_KEY_SIZE];
+    char         m_peak_key[MEMORY_TAG_KEY_SIZE];
+};
+
+static bool             g_memory_profile           = false;
+static long long        g_memory_profile_step      = 0;
+static long long        g_memory_profile_live      = 0;
+static long long        g_memory_profile_next_dump = 0;
+static unsigned         g_memory_num_tags          = 0;
+static memory_tag_stats g_memory_tags[MAX_MEMORY_TAGS];
+
+// While the profiler is enabled, the tag of a block plus one is stored in the
+// upper byte of the size field in front of the block; 0 means not profiled.
+// This needs 64-bit size fields, so the profiler is not available otherwise.
+static const bool     g_memory_profile_supported = sizeof(size_t) >= 8;
+static const unsigned TAG_SHIFT                  = g_memory_profile_supported ? sizeof(size_t) * 8 - 8 : 0;
+static const size_t   SIZE_MASK                  = g_memory_profile_supported ? (static_cast<size_t>(1) << TAG_SHIFT) - 1 : ~static_cast<size_t>(0);
+
+static inline size_t block_size(size_t hdr) {
+    return hdr & SIZE_MASK;
+}
+
+static inline unsigned block_tag(size_t hdr) {
+    return g_memory_profile_supported ? static_cast<unsigned>(hdr >> TAG_SHIFT) : 0;
+}
+
+static unsigned mk_tag_core(char const * name) {
+    for (unsigned i = 0; i < g_memory_num_tags; i++) {
+        if (strcmp(g_memory_tags[i].m_name, name) == 0)
+            return i;
+    }
+    if (g_memory_num_tags == MAX_MEMORY_TAGS)
+        return 0;
+    memory_tag_stats & t = g_memory_tags[g_memory_num_tags];
+    t.m_name  = name;
+    t.m_live  = 0;
+    t.m_peak  = 0;
+    t.m_count = 0;
+    snprintf(t.m_live_key, MEMORY_TAG_KEY_SIZE, "memory %s", name);
+    snprintf(t.m_peak_key, MEMORY_TAG_KEY_SIZE, "max memory %s", name);
+    return g_memory_num_tags++;
+}
+
+/**
+   \brief Attribute sz bytes to tag, and return the bits to store in the size field of the block.
+*/
+static size_t profile_alloc(unsigned tag, size_t sz) {
+    bool dump = false;
+    #pragma omp critical (z3_memory_profile)
+    {
+        if (tag >= g_memory_num_tags)
+            tag = 0;
+        memory_tag_stats & t = g_memory_tags[tag];
+        t.m_live += sz;
+        t.m_count++;
+        if (t.m_live > t.m_peak)
+            t.m_peak = t.m_live;
+        g_memory_profile_live += sz;
+        if (g_memory_profile_step != 0 && g_memory_profile_live >= g_memory_profile_next_dump) {
+            g_memory_profile_next_dump = g_memory_profile_live + g_memory_profile_step;
+            dump = true;
+        }
+    }
+    if (dump)
+        memory::display_profile(std::cerr);
+    return static_cast<size_t>(tag + 1) << TAG_SHIFT;
+}
+
+static inline size_t profile_alloc(size_t sz) {
+    if (!g_memory_profile)
+        return 0;
+    return profile_alloc(g_memory_thread_tag, sz);
+}
+
+static void profile_free(size_t hdr) {
+    unsigned tag = block_tag(hdr);
+    if (tag == 0)
+        return;
+    long long sz = block_size(hdr);
+    #pragma omp critical (z3_memory_profile)
+    {
+        g_memory_tags[tag - 1].m_live -= sz;
+        g_memory_profile_live -= sz;
+    }
+}
+
+void memory::set_profile(bool flag) {
+    g_memory_profile = flag && g_memory_profile_supported;
+    if (g_memory_profile) {
+        #pragma omp critical (z3_memory_profile)
+        {
+            if (g_memory_num_tags == 0)
+                mk_tag_core("other");
+        }
+    }
+}
+
+bool memory::profile_enabled() {
+    return g_memory_profile;
+}
+
+void memory::set_profile_dump_step(size_t step) {
+    g_memory_profile_step = step;
+    g_memory_profile_next_dump = step;
+}
+
+unsigned memory::mk_tag(char const * name) {
+    unsigned r = 0;
+    #pragma omp critical (z3_memory_profile)
+    {
+        if (g_memory_num_tags == 0)
+            mk_tag_core("other");
+        r = mk_tag_core(name);
+    }
+    return r;
+}
+
+unsigned memory::set_tag(unsigned tag) {
+    unsigned old = g_memory_thread_tag;
+    g_memory_thread_tag = tag;
+    return old;
+}
+
+struct memory_tag_snapshot {
+    char const * m_name;
+    long long    m_live;
+    long long    m_peak;
+    long long    m_count;
+};
+
+static unsigned copy_profile(memory_tag_snapshot * tags, long long & live) {
+    unsigned n = 0;
+    #pragma omp critical (z3_memory_profile)
+    {
+        n = g_memory_num_tags;
+        for (unsigned i = 0; i < n; i++) {
+            tags[i].m_name  = g_memory_tags[i].m_name;
+            tags[i].m_live  = g_memory_tags[i].m_live;
+            tags[i].m_peak  = g_memory_tags[i].m_peak;
+            tags[i].m_count = g_memory_tags[i].m_count;
+        }
+        live = g_memory_profile_live;
+    }
+    return n;
+}
+
+void memory::display_profile(std::ostream & out) {
+    memory_tag_snapshot tags[MAX_MEMORY_TAGS];
+    long long live = 0;
+    unsigned n = copy_profile(tags, live);
+    out << "{\"memory-profile\": {\"live\": " << live
+        << ", \"max-used\": " << get_max_used_memory()
+        << ", \"tags\": [";
+    bool first = true;
+    for (unsigned i = 0; i < n; i++) {
+        if (tags[i].m_count == 0)
+            continue;
+        if (!first)
+            out << ", ";
+        first = false;
+        out << "{\"name\": \"" << tags[i].m_name
+            << "\", \"live\": " << tags[i].m_live
+            << ", \"peak\": " << tags[i].m_peak
+            << ", \"allocs\": " << tags[i].m_count << "}";
+    }
+    out << "]}}" << std::endl;
+}
+
+void memory::collect_profile_statistics(statistics & st) {
+    if (!g_memory_profile)
+        return;
+    memory_tag_snapshot tags[MAX_MEMORY_TAGS];
+    long long live = 0;
+    unsigned n = copy_profile(tags, live);
+    for (unsigned i = 0; i < n; i++) {
+        if (tags[i].m_count == 0)
+            continue;
+        // the keys must outlive st, so they point into g_memory_tags.
+        st.update(g_memory_tags[i].m_live_key, static_cast<double>(tags[i].m_live)/static_cast<double>(1024*1024));
+        st.update(g_memory_tags[i].m_peak_key, static_cast<double>(tags[i].m_peak)/static_cast<double>(1024*1024));
+    }
+}
+
 static void throw_out_of_memory() {
     #pragma omp critical (z3_memory_manager) 
     {
         g_memory_out_of_memory = true;
     }
+    if (g_memory_profile)
+        memory::display_profile(std::cerr);
     if (g_exit_when_out_of_memory) {
         std::cerr << g_out_of_memory_msg << "\n";
         exit(ERR_MEMOUT);
@@ -232,6 +442,18 @@ __declspec(thread) long long g_memory_thread_alloc_count   = 0;
 __thread long long g_memory_thread_alloc_size    = 0;
 __thread long long g_memory_thread_alloc_count  = 0;
 #endif
+// memory allocated by the thread since the last call to set_thread_max_size,
+// updated only when synchronizing, the limit set by that call, and the
+// resource limit to mark when it is exceeded.
+#ifdef _WINDOWS
+__declspec(thread) long long g_memory_thread_used_size     = 0;
+__declspec(thread) long long g_memory_thread_max_size      = 0;
+__declspec(thread) reslimit * g_memory_thread_limit        = nullptr;
+#else
+__thread long long g_memory_thread_used_size   = 0;
+__thread long long g_memory_thread_max_size    = 0;
+__thread reslimit * g_memory_thread_limit      = nullptr;
+#endif
 
 static void synchronize_counters(bool allocating) {
 #ifdef PROFILE_MEMORY
@@ -251,7 +473,13 @@ static void synchronize_counters(bool allocating) {
         if (g_memory_max_alloc_count != 0 && g_memory_alloc_count > g_memory_max_alloc_count)
             counts_exceeded = true;
     }
+    g_memory_thread_used_size += g_memory_thread_alloc_size;
     g_memory_thread_alloc_size = 0;
+    g_memory_thread_alloc_count = 0;
+    if (g_memory_thread_limit != nullptr && g_memory_thread_used_size > g_memory_thread_max_size) {
+        g_memory_thread_limit->set_memory_exceeded();
+        g_memory_thread_limit = nullptr;
+    }
     if (out_of_mem && allocating) {
         throw_out_of_memory();
     }
@@ -260,10 +488,21 @@ static void synchronize_counters(bool allocating) {
     }
 }
 
+void memory::synchronize_thread_counters() {
+    synchronize_counters(false);
+}
+
+void memory::set_thread_max_size(size_t max_size, reslimit * lim) {
+    g_memory_thread_used_size = 0;
+    g_memory_thread_max_size  = max_size;
+    g_memory_thread_limit     = max_size != 0 ? lim : nullptr;
+}
+
 void memory::deallocate(void * p) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
-    size_t sz      = *sz_p;
+    size_t sz      = block_size(*sz_p);
     void * real_p  = reinterpret_cast<void*>(sz_p);
+    profile_free(*sz_p);
     g_memory_thread_alloc_size -= sz;
     free(real_p);
     if (g_memory_thread_alloc_size < -SYNCH_THRESHOLD) {
@@ -276,7 +515,7 @@ void * memory::allocate(size_t s) {
     void * r = malloc(s);
     if (r == 0) 
         throw_out_of_memory();
-    *(static_cast<size_t*>(r)) = s;
+    *(static_cast<size_t*>(r)) = s | profile_alloc(s);
     g_memory_thread_alloc_size += s;
     g_memory_thread_alloc_count += 1;
     if (g_memory_thread_alloc_size > SYNCH_THRESHOLD) {
@@ -287,7 +526,8 @@ void * memory::allocate(size_t s) {
 
 void* memory::reallocate(void *p, size_t s) {
     size_t *sz_p = reinterpret_cast<size_t*>(p)-1;
-    size_t sz = *sz_p;
+    size_t hdr = *sz_p;
+    size_t sz = block_size(hdr);
     void *real_p = reinterpret_cast<void*>(sz_p);
     s = s + sizeof(size_t); // we allocate an extra field!
 
@@ -300,7 +540,8 @@ void* memory::reallocate(void *p, size_t s) {
     void *r = realloc(real_p, s);
     if (r == 0)
         throw_out_of_memory();
-    *(static_cast<size_t*>(r)) = s;
+    profile_free(hdr);
+    *(static_cast<size_t*>(r)) = s | (block_tag(hdr) == 0 ? 0 : profile_alloc(block_tag(hdr) - 1, s));
     return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
 }
 
@@ -312,10 +553,19 @@ void* memory::reallocate(void *p, size_t s) {
 // ==================================
 // allocate & deallocate without using thread local storage
 
+void memory::synchronize_thread_counters() {
+}
+
+void memory::set_thread_max_size(size_t max_size, reslimit * lim) {
+    if (max_size != 0)
+        warning_msg("the memory limit of a thread is not supported without thread local storage, it is ignored");
+}
+
 void memory::deallocate(void * p) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
-    size_t sz      = *sz_p;
+    size_t sz      = block_size(*sz_p);
     void * real_p  = reinterpret_cast<void*>(sz_p);
+    profile_free(*sz_p);
     #pragma omp critical (z3_memory_manager) 
     {
         g_memory_alloc_size -= sz;
@@ -344,13 +594,14 @@ void * memory::allocate(size_t s) {
     void * r = malloc(s);
     if (r == nullptr)
         throw_out_of_memory();
-    *(static_cast<size_t*>(r)) = s;
+    *(static_cast<size_t*>(r)) = s | profile_alloc(s);
     return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
 }
 
 void* memory::reallocate(void *p, size_t s) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
-    size_t sz      = *sz_p;
+    size_t hdr     = *sz_p;
+    size_t sz      = block_size(hdr);
     void * real_p  = reinterpret_cast<void*>(sz_p);
     s = s + sizeof(size_t); // we allocate an extra field!
     bool out_of_mem = false, counts_exceeded = false;
@@ -372,7 +623,8 @@ void* memory::reallocate(void *p, size_t s) {
     void *r = realloc(real_p, s);
     if (r == nullptr)
         throw_out_of_memory();
-    *(static_cast<size_t*>(r)) = s;
+    profile_free(hdr);
+    *(static_cast<size_t*>(r)) = s | (block_tag(hdr) == 0 ? 0 : profile_alloc(block_tag(hdr) - 1, s));
     return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
 }
  
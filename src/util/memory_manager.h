@@ -41,6 +41,9 @@ Revision History:
 #endif
 
 
+class statistics;
+class reslimit;
+
 class out_of_memory_error : public z3_error {
 public:
     out_of_memory_error();
@@ -54,6 +57,12 @@ public:
     static bool above_high_watermark();
     static void set_max_size(size_t max_size);
     static void set_max_alloc_count(size_t max_count);
+    // Limit the memory allocated (and not freed) by the calling thread from now on;
+    // 0 removes the limit. Allocations do not fail when the limit is exceeded, instead
+    // the thread marks lim as out of memory the next time it synchronizes its counters,
+    // and lim reports that the resource is exhausted.
+    // The limit is not supported (and a warning is reported) without thread local storage.
+    static void set_thread_max_size(size_t max_size, reslimit * lim);
     static void finalize();
     static void display_max_usage(std::ostream& os);
     static void display_i_max_usage(std::ostream& os);
@@ -67,8 +76,43 @@ public:
     static unsigned long long get_allocation_size();
     static unsigned long long get_max_used_memory();
     static unsigned long long get_allocation_count();
+    // Add the allocations of the calling thread that were not accounted for yet
+    // to the counters above (this happens otherwise every SYNCH_THRESHOLD bytes).
+    static void synchronize_thread_counters();
     // temporary hack to avoid out-of-memory crash in z3.exe
     static void exit_when_out_of_memory(bool flag, char const * msg);
+
+    // Allocation profiler.
+    // When enabled, every allocation is attributed to the tag that is active
+    // in the allocating thread (see scoped_memory_tag), and live, peak and
+    // count figures are kept per tag. Allocations made before the profiler
+    // was enabled are not attributed.
+    static void set_profile(bool flag);
+    static bool profile_enabled();
+    // dump the profile (as JSON) whenever the profiled live size grew by step bytes, 0 disables the dumps.
+    static void set_profile_dump_step(size_t step);
+    static unsigned mk_tag(char const * name);
+    static unsigned set_tag(unsigned tag);
+    static void display_profile(std::ostream & out);
+    static void collect_profile_statistics(statistics & st);
+};
+
+/**
+   \brief Attribute the allocations of the current thread to the tag name while in scope.
+   The name must be a string literal. Nothing happens if the profiler is disabled.
+*/
+class scoped_memory_tag {
+    bool     m_active;
+    unsigned m_old;
+public:
+    scoped_memory_tag(char const * name): m_active(memory::profile_enabled()), m_old(0) {
+        if (m_active)
+            m_old = memory::set_tag(memory::mk_tag(name));
+    }
+    ~scoped_memory_tag() {
+        if (m_active)
+            memory::set_tag(m_old);
+    }
 };
 
 
@@ -22,6 +22,7 @@ Revision History:
 reslimit::reslimit():
     m_cancel(0),
     m_suspend(false),
+    m_memory_exceeded(false),
     m_count(0),
     m_limit(0) {
 }
@@ -32,12 +33,12 @@ uint64 reslimit::count() const {
 
 bool reslimit::inc() {
     ++m_count;
-    return (m_cancel == 0 && (m_limit == 0 || m_count <= m_limit)) || m_suspend;
+    return (m_cancel == 0 && (m_limit == 0 || m_count <= m_limit) && !m_memory_exceeded) || m_suspend;
 }
 
 bool reslimit::inc(unsigned offset) {
     m_count += offset;
-    return (m_cancel == 0 && (m_limit == 0 || m_count <= m_limit)) || m_suspend;
+    return (m_cancel == 0 && (m_limit == 0 || m_count <= m_limit) && !m_memory_exceeded) || m_suspend;
 }
 
 void reslimit::push(unsigned delta_limit) {
@@ -63,6 +64,9 @@ char const* reslimit::get_cancel_msg() const {
     if (m_cancel > 0) {
         return Z3_CANCELED_MSG;
     }
+    else if (m_memory_exceeded) {
+        return Z3_MAX_MEMORY_MSG;
+    }
     else {
         return Z3_MAX_RESOURCE_MSG;
     }
@@ -24,6 +24,7 @@ Revision History:
 class reslimit {
     volatile unsigned   m_cancel;
     bool            m_suspend;
+    bool            m_memory_exceeded;
     uint64          m_count;
     uint64          m_limit;
     svector<uint64> m_limits;
@@ -51,6 +52,10 @@ public:
 
     void inc_cancel();
     void dec_cancel();
+
+    // called by the thread using this limit when it exceeded its memory limit,
+    // see memory::set_thread_max_size.
+    void set_memory_exceeded() { m_memory_exceeded = true; }
 };
 
 class scoped_rlimit {
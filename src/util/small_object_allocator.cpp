@@ -30,9 +30,7 @@ small_object_allocator::small_object_allocator(char const * id) {
         m_chunks[i] = nullptr;
         m_free_list[i] = nullptr;
     }
-    DEBUG_CODE({
-        m_id = id;
-    });
+    m_id = id;
     m_alloc_size = 0;
 }
 
@@ -129,6 +127,8 @@ void * small_object_allocator::allocate(size_t size) {
             return r;
         }
     }
+    // with the allocation profiler, pool memory is attributed to the allocator id.
+    scoped_memory_tag _mt(m_id);
     chunk * new_c = alloc(chunk);
     new_c->m_next = c;
     m_chunks[slot_id] = new_c;
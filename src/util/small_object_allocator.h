@@ -36,9 +36,7 @@ class small_object_allocator {
     chunk *     m_chunks[NUM_SLOTS];
     void  *     m_free_list[NUM_SLOTS];
     size_t      m_alloc_size;
-#ifdef Z3DEBUG
     char const * m_id;
-#endif
 public:
     small_object_allocator(char const * id = "unknown");
     ~small_object_allocator();
@@ -244,6 +244,7 @@ void get_memory_statistics(statistics& st) {
     st.update("max memory", static_cast<double>(max_mem)/100.0);    
     st.update("memory", static_cast<double>(mem)/100.0);
     get_uint64_stats(st, "num allocs",  memory::get_allocation_count());
+    memory::collect_profile_statistics(st);
 }
 
 void get_rlimit_statistics(reslimit& l, statistics& st) {
@@ -21,41 +21,75 @@ Revision History:
 #include "util/region.h"
 #include "util/string_buffer.h"
 #include "util/z3_omp.h"
+#include<atomic>
 
 symbol symbol::m_dummy(TAG(void*, nullptr, 2));
 const symbol symbol::null;
 
 /**
    \brief Symbol table manager. It stores the symbol strings created at runtime.
+
+   The table is split into independent stripes, each with its own lock,
+   region and hashtable, so that threads creating symbols concurrently
+   rarely wait for each other.
+   Most lookups are for strings that already are symbols. They are answered
+   without the lock by a direct mapped cache of recently returned symbols:
+   a cache slot is only published after the symbol string is complete, and
+   symbol strings are never modified afterwards.
 */
 class internal_symbol_table {
-    region        m_region; //!< Region used to store symbol strings.
-    str_hashtable m_table;  //!< Table of created symbol strings.
+    static const unsigned NUM_STRIPES = 32;
+    static const unsigned CACHE_SIZE  = 256; // per stripe, a power of two
+
+    struct stripe {
+        omp_lock_t                m_lock;
+        region                    m_region; //!< Region used to store symbol strings.
+        str_hashtable             m_table;  //!< Table of created symbol strings.
+        std::atomic<char const *> m_cache[CACHE_SIZE];
+        stripe() {
+            omp_init_lock(&m_lock);
+            for (unsigned i = 0; i < CACHE_SIZE; ++i)
+                m_cache[i].store(nullptr, std::memory_order_relaxed);
+        }
+        ~stripe() { omp_destroy_lock(&m_lock); }
+    };
+
+    stripe m_stripes[NUM_STRIPES];
+
 public:
 
     char const * get_str(char const * d) {
+        size_t l = strlen(d);
+        // same hash as str_hash_proc, it is stored before the symbol string.
+        unsigned h = string_hash(d, static_cast<unsigned>(l), 17);
+        stripe & s = m_stripes[h % NUM_STRIPES];
+        std::atomic<char const *> & slot = s.m_cache[(h / NUM_STRIPES) & (CACHE_SIZE - 1)];
+        char const * c = slot.load(std::memory_order_acquire);
+        if (c != nullptr && reinterpret_cast<size_t const*>(c)[-1] == h && strcmp(c, d) == 0)
+            return c;
+
         char * result;
-        #pragma omp critical (cr_symbol) 
         {
-        char * r_d = const_cast<char *>(d);
-        str_hashtable::entry * e;
-        if (m_table.insert_if_not_there_core(r_d, e)) {
-            // new entry
-            size_t l   = strlen(d);
-            // store the hash-code before the string
-            size_t * mem = static_cast<size_t*>(m_region.allocate(l + 1 + sizeof(size_t)));
-            *mem = e->get_hash();
-            mem++;
-            result = reinterpret_cast<char*>(mem);
-            memcpy(result, d, l+1);
-            // update the entry with the new ptr.
-            e->set_data(result);
-        }
-        else {
-            result = e->get_data();
-        }
-        SASSERT(m_table.contains(result));
+            scoped_omp_lock lock(s.m_lock);
+            char * r_d = const_cast<char *>(d);
+            str_hashtable::entry * e;
+            if (s.m_table.insert_if_not_there_core(r_d, e)) {
+                // new entry
+                // store the hash-code before the string
+                size_t * mem = static_cast<size_t*>(s.m_region.allocate(l + 1 + sizeof(size_t)));
+                *mem = e->get_hash();
+                mem++;
+                result = reinterpret_cast<char*>(mem);
+                memcpy(result, d, l+1);
+                // update the entry with the new ptr.
+                e->set_data(result);
+            }
+            else {
+                result = e->get_data();
+            }
+            SASSERT(s.m_table.contains(result));
         }
+        slot.store(result, std::memory_order_release);
         return result;
     }
 };
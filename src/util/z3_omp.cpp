@@ -0,0 +1,62 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    z3_omp.cpp
+
+Abstract:
+
+    Bound on the number of threads used by parallel regions.
+
+Notes:
+
+--*/
+#include "util/z3_omp.h"
+
+static unsigned g_max_threads      = 0; // 0 if unbounded
+static unsigned g_active_threads   = 0; // threads of the active regions, including the threads that started them
+
+void set_max_omp_threads(unsigned n) {
+    #pragma omp critical (z3_omp_threads)
+    {
+        g_max_threads = n;
+    }
+}
+
+scoped_omp_threads::scoped_omp_threads(unsigned num_tasks):
+    m_num(1),
+    m_reserved(false) {
+    if (omp_in_parallel()) {
+        // the calling thread is already counted by the enclosing region,
+        // and nested regions run in the calling thread only.
+        return;
+    }
+    unsigned workers = num_tasks > 0 ? num_tasks - 1 : 0;
+    // never more threads than a region gets by default (OMP_NUM_THREADS, or the number of cores).
+    int max_team = omp_get_max_threads();
+    if (max_team < 1)
+        max_team = 1;
+    if (workers > static_cast<unsigned>(max_team) - 1)
+        workers = static_cast<unsigned>(max_team) - 1;
+    #pragma omp critical (z3_omp_threads)
+    {
+        if (g_max_threads != 0) {
+            unsigned avail = g_max_threads > 1 + g_active_threads ? g_max_threads - 1 - g_active_threads : 0;
+            if (workers > avail)
+                workers = avail;
+        }
+        g_active_threads += workers + 1;
+    }
+    m_num = workers + 1;
+    m_reserved = true;
+}
+
+scoped_omp_threads::~scoped_omp_threads() {
+    if (!m_reserved)
+        return;
+    #pragma omp critical (z3_omp_threads)
+    {
+        g_active_threads -= m_num;
+    }
+}
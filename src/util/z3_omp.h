@@ -26,13 +26,58 @@ Notes:
 #define omp_set_num_threads(SZ) ((void)0)
 #define omp_get_thread_num() 0
 #define omp_get_num_procs()  1
+#define omp_get_max_threads() 1
 #define omp_set_nested(V) ((void)0)
 #define omp_init_nest_lock(L) ((void) 0)
 #define omp_destroy_nest_lock(L) ((void) 0)
 #define omp_set_nest_lock(L) ((void) 0)
 #define omp_unset_nest_lock(L) ((void) 0)
+#define omp_init_lock(L) ((void) 0)
+#define omp_destroy_lock(L) ((void) 0)
+#define omp_set_lock(L) ((void) 0)
+#define omp_unset_lock(L) ((void) 0)
 struct omp_nest_lock_t {
 };
+struct omp_lock_t {
+};
 #endif
 
+/**
+   \brief Hold the given (non nested) lock until the end of the scope.
+*/
+class scoped_omp_lock {
+    omp_lock_t & m_lock;
+public:
+    scoped_omp_lock(omp_lock_t & l):m_lock(l) { omp_set_lock(&m_lock); }
+    ~scoped_omp_lock() { omp_unset_lock(&m_lock); }
+};
+
+/**
+   \brief Bound the number of threads used at the same time by all parallel
+   regions (par-or, par-then, the SAT portfolio), including the threads that
+   start them. 0 means no bound. It is set by the global parameter threads_max.
+*/
+void set_max_omp_threads(unsigned n);
+
+/**
+   \brief Reserve threads for a parallel region with the given number of tasks.
+   A region never gets more threads than omp_get_max_threads(), i.e., the OpenMP
+   default team size. In addition, the threads of all active regions, including
+   the threads that started them, count against the bound set by
+   set_max_omp_threads. The calling thread is
+   always available, so get() is at least 1; when several threads start regions
+   at the same time, the starting threads alone may exceed the bound.
+   The threads are reserved until the object is destroyed.
+   Inside a parallel region nothing is reserved and get() is 1.
+   Use it as: #pragma omp parallel for num_threads(t.get())
+*/
+class scoped_omp_threads {
+    unsigned m_num;
+    bool     m_reserved;
+public:
+    scoped_omp_threads(unsigned num_tasks);
+    ~scoped_omp_threads();
+    int get() const { return static_cast<int>(m_num); }
+};
+
 #endif